@@ -0,0 +1,215 @@
+#include "Acquisition.h"
+#include <cstdio>
+#include "Globals.h"
+#include "Trace.h"
+
+// 一个井在一帧上的处理：解码、按该井游戏的距离评估刺激、把解码跳跃交给该井的游戏
+static void StepWell(WellLoop& loop, StimDispatcher& dispatcher, int slot, uint64_t frame_no, const maxlab::SpikeEvent* spikes, uint64_t count, uint64_t recv_ns) {
+    WellLink& link = well_links[slot];
+    const uint8_t well = well_layout.ids[slot];
+    const int distance = link.obstacle_distance.load(std::memory_order_relaxed);
+    StimScheduler& scheduler = *loop.scheduler;
+    StimTimerId& stim_timer = loop.stim_timer;
+
+    // 把一次刺激交给刺激线程；与未完成的同一刺激合并时不再记录
+    auto submit_stim = [&](const char* name, int sequence) {
+        StimCommand command{frame_no, recv_ns, loop.pending_cross_ns, 0, 0, static_cast<int16_t>(sequence),
+                            static_cast<uint8_t>(slot), {}};
+        snprintf(command.name, sizeof(command.name), "%s", name);
+        AcquisitionMetrics& acq_metrics = metrics.Data().acquisition;
+        switch (dispatcher.Submit(command)) {
+            case StimSubmit::Queued:
+                TRACE(Trace_Info, Trace_Stim, sequence, frame_no);
+                recorder.AppendEvent(Lane_Acquisition, Event_Stim, frame_no, sequence, well);
+                link.response.Stimulus(frame_no, sequence);
+                break;
+            case StimSubmit::Merged:
+                Bump(acq_metrics.stims_merged);
+                break;
+            case StimSubmit::Dropped:
+                Bump(acq_metrics.stims_dropped);
+                break;
+        }
+        loop.pending_cross_ns = 0;
+    };
+
+    // 在线 PSTH：刺激窗口结束时更新该井的诱发响应
+    if (link.response.Advance(frame_no) > 0) {
+        WellMetrics& well_metrics = metrics.Data().well[slot];
+        for (int sequence = 1; sequence <= kResponseSequences; ++sequence) {
+            const EvokedResponse evoked = link.response.Evoked(sequence);
+            Gauge(well_metrics.evoked_trials[sequence - 1], evoked.trials);
+            Gauge(well_metrics.evoked_permille[sequence - 1], static_cast<uint64_t>(evoked.RecentRatio() * 1000));
+        }
+    }
+    link.response.AddSpikes(spikes, count);
+
+    const bool decoded_jump = loop.decoder->Update(frame_no, spikes, count);
+
+    TRACE(Trace_Debug, Trace_Distance, distance, frame_no);
+    TRACE(Trace_Debug, Trace_Isi, scheduler.Pending(stim_timer) ? scheduler.Due(stim_timer) - frame_no : 0, frame_no);
+
+    // 策略表按距离查表；每帧取一次当前版本，开局时可能被游戏线程替换
+    const StimPolicy* policy = stim_policies.Current();
+    const PolicyEntry& entry = policy->Lookup(distance);
+
+    if(entry.immediate) {       //当距离在这个区间时，需要立即给出刺激，所以把待定的刺激改期到当前帧，reset_isi 保证只会改期一次
+        if (loop.reset_isi) {          //防止发送过多序列
+                scheduler.Reschedule(stim_timer, frame_no);
+                loop.reset_isi = false; // 重置后，将reset_blanking设为false
+                loop.pending_cross_ns = link.cross_ns.load(std::memory_order_relaxed);
+            }
+    }
+    else{
+            loop.reset_isi = true;    //允许重置isi
+    }
+    if (entry.band != loop.once_band) {
+        loop.once_band = -1;         //离开只发一次的区间后允许再次发送
+    }
+
+    // 到期的定时器在这里释放，随后按当前距离评估是否刺激
+    scheduler.Advance(frame_no, [](StimTimerId, int, uint64_t) {});
+
+    if(!scheduler.Pending(stim_timer)){
+        stim_timer = kNoTimer;
+        if (entry.band >= 0 && entry.band != loop.once_band) {
+            char buffer[96];
+            const char* name = WellSequenceName(well_layout, slot, policy->SequenceName(entry.sequence), buffer, sizeof(buffer));
+            submit_stim(name, entry.sequence);
+            if (entry.once) {
+                loop.once_band = entry.band;
+            }
+            if (entry.isi_mode != Isi_None) {
+                stim_timer = scheduler.Schedule(frame_no + policy->IsiFrames(entry, distance), entry.sequence);
+            }
+        }
+    }
+
+
+    // 刺激后的空白期不解码；与原 isi 计数一致，下一次刺激前的最后一帧参与解码
+    // 空白期内越过阈值的那次留到空白期后：窗口仍在阈值以上时在第一帧判定
+    if(scheduler.Pending(stim_timer) && scheduler.Due(stim_timer) > frame_no + 1){
+        if (decoded_jump) {
+            loop.decoder->Rearm();
+        }
+        return;
+    }
+
+    if(decoded_jump){
+        const uint64_t decide_ns = MonotonicNs();
+        TRACE(Trace_Info, Trace_SpikeCount, loop.decoder->MaskedTotal(), frame_no);
+        // 交给该井的游戏在下一个 tick 消费，队列满时计入 dropped
+        DecoderEvent ev{frame_no, loop.decoder->MaskedTotal(), DecoderAction::Jump, recv_ns, decide_ns, 0};
+        ev.push_ns = MonotonicNs();
+        link.decoder_events.Push(ev);
+        Bump(metrics.Data().acquisition.jumps_decoded);
+        Bump(metrics.Data().well[slot].jumps_decoded);
+        latency.Record(Stage_Recv_Decide, recv_ns, decide_ns);
+        latency.Record(Stage_Decide_Push, decide_ns, ev.push_ns);
+        TRACE(Trace_Info, Trace_Jump, frame_no, loop.decoder->MaskedTotal());
+        recorder.AppendEvent(Lane_Acquisition, Event_JumpDecoded, frame_no, distance, well);
+        //blanking = 20000;  //2000 samples,100ms
+    }
+}
+
+void AcquisitionLoop::Configure(bool raw) {
+    raw_stream = raw;
+    // 每个井一套解码器、调度器（原始流时还有检测器）；一个线程收流，按井号分发
+    loops = std::vector<WellLoop>(well_layout.count);
+    const DecoderConfig decoder_config = DecoderConfigFromEnv();
+    for (WellLoop& loop : loops) {
+        if (!loop.decoder->Configure(decoder_config)) {
+            loop.decoder->Configure(DecoderConfig());
+        }
+    }
+    demux.Configure(well_layout);
+    if (raw_stream) {
+        const RawDetectorConfig raw_config = RawDetectorConfigFromEnv();
+        for (WellLoop& loop : loops) {
+            loop.raw_detector = std::make_unique<RawDetector>();
+            if (!loop.raw_detector->Configure(raw_config)) {
+                loop.raw_detector->Configure(RawDetectorConfig());
+            }
+        }
+    }
+    const FrameMonitor monitor_template(FrameDeadlineUsFromEnv());
+    monitors.assign(raw_stream ? well_layout.count : 1, monitor_template);
+    frame_no = 0;
+    frame_known = false;
+    raw_unrouted = 0;
+}
+
+void AcquisitionLoop::Empty() {
+    for (FrameMonitor& monitor : monitors) {
+        monitor.Empty();
+    }
+}
+
+// 帧号缺口、损坏帧、积压和实时期限
+static void WatchFrame(FrameMonitor& monitor, uint64_t frame_no, uint64_t recv_ns, bool corrupted) {
+    AcquisitionMetrics& acq_metrics = metrics.Data().acquisition;
+    const uint64_t late_before = monitor.LateFrames();
+    const uint64_t misses_before = monitor.DeadlineMisses();
+    const uint64_t missing = monitor.Received(frame_no, recv_ns, corrupted);
+    if (missing > 0) {
+        TRACE(Trace_Info, Trace_FrameGap, missing, frame_no);
+        Bump(acq_metrics.missing_frames, missing);
+    }
+    if (corrupted) {
+        Bump(acq_metrics.corrupted_frames);
+    }
+    if (monitor.LateFrames() != late_before) {
+        Bump(acq_metrics.late_frames);
+        if (monitor.DeadlineMisses() != misses_before) {
+            TRACE(Trace_Info, Trace_Deadline, monitor.LagFrames(), frame_no);
+        }
+    }
+    Gauge(acq_metrics.lag_frames, monitor.LagFrames());
+    if (monitor.Backlog() > acq_metrics.max_backlog.load(std::memory_order_relaxed)) {
+        Gauge(acq_metrics.max_backlog, monitor.Backlog());
+    }
+}
+
+void AcquisitionLoop::FilteredFrame(StimDispatcher& dispatcher, const maxlab::FilteredFrameData& frameData, uint64_t recv_ns) {
+    AcquisitionMetrics& acq_metrics = metrics.Data().acquisition;
+    ++frame_no;
+    for (uint64_t i = 0; i < frameData.spikeCount; ++i) {
+        if (frameData.spikeEvents[i].frameNo > frame_no)
+            frame_no = frameData.spikeEvents[i].frameNo;
+    }
+    frame_known = frame_known || frameData.spikeCount > 0;
+    if (frame_known) {
+        WatchFrame(monitors[0], frame_no, recv_ns, false);
+    }
+    acq_frame.store(frame_no, std::memory_order_release);
+    recorder.AppendSpikes(frameData.spikeEvents, frameData.spikeCount);
+    Bump(acq_metrics.spikes, frameData.spikeCount);
+    Gauge(acq_metrics.last_frame, frame_no);
+
+    // 滤波流的一帧包含所有井的 spike，按井号分开后每个井都推进一帧
+    demux.Split(frameData.spikeEvents, frameData.spikeCount);
+    for (int slot = 0; slot < static_cast<int>(loops.size()); ++slot) {
+        StepWell(loops[slot], dispatcher, slot, frame_no, demux.Spikes(slot), demux.Count(slot), recv_ns);
+    }
+}
+
+void AcquisitionLoop::RawFrame(StimDispatcher& dispatcher, const maxlab::RawFrameData& rawFrame, uint64_t recv_ns) {
+    AcquisitionMetrics& acq_metrics = metrics.Data().acquisition;
+    // 原始流每帧只属于一个井；检测结果与滤波流的 spike 格式相同，后面的解码和记录不区分来源
+    frame_no = rawFrame.frameInfo.frame_number;     // 原始流自带帧号
+    acq_frame.store(frame_no, std::memory_order_release);
+    const int slot = well_layout.demux ? well_layout.slot[rawFrame.frameInfo.well_id] : 0;
+    if (slot < 0) {
+        ++raw_unrouted;
+        return;
+    }
+    // 损坏帧的数据没有保证，不送检测器，但解码器和刺激调度照常推进一帧
+    const bool corrupted = rawFrame.frameInfo.corrupted;
+    WatchFrame(monitors[slot], frame_no, recv_ns, corrupted);
+    WellLoop& loop = loops[slot];
+    const uint32_t count = corrupted ? 0 : loop.raw_detector->Process(frame_no, rawFrame.amplitudes, rawFrame.frameInfo.well_id);
+    recorder.AppendSpikes(loop.raw_detector->Spikes(), count);
+    Bump(acq_metrics.spikes, count);
+    Gauge(acq_metrics.last_frame, frame_no);
+    StepWell(loop, dispatcher, slot, frame_no, loop.raw_detector->Spikes(), count, recv_ns);
+}
@@ -0,0 +1,49 @@
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "maxlab/include/maxlab/data_streamer.h"
+#include "SpikeDecoder.h"
+#include "StimScheduler.h"
+#include "RawDetector.h"
+#include "StimDispatcher.h"
+#include "FrameMonitor.h"
+#include "Wells.h"
+
+// 采集线程中一个井的闭环状态，各井互不影响
+struct WellLoop {
+    // 逐通道滑动窗口解码器，参数见 SpikeDecoder.h
+    std::unique_ptr<SpikeDecoder> decoder = std::make_unique<SpikeDecoder>();
+    // 刺激间隔以绝对帧号计时，丢帧或轮询延迟不会拉长间隔
+    std::unique_ptr<StimScheduler> scheduler = std::make_unique<StimScheduler>();
+    std::unique_ptr<RawDetector> raw_detector;  // 原始流时每个井一个，滤波器状态不共用
+    StimTimerId stim_timer = kNoTimer;     // 下一次按策略评估刺激的时刻；无定时器时每帧评估
+    bool reset_isi = true;
+    int once_band = -1;     // 已发送过的只发一次区间
+    uint64_t pending_cross_ns = 0;  // 越过 200 px 后尚未发出的那次刺激
+};
+
+// 采集线程收到一帧之后的全部处理：帧号与缺口检测、会话记录、计数、按井分发，
+// 再对每个井解码、按该井游戏的距离评估刺激、提交刺激、把解码跳跃交给该井的游戏。
+// 收流、线程设置和退出时的汇总在 message_thread 中；Dino_bench 直接驱动这里的每帧处理
+struct AcquisitionLoop {
+    std::vector<WellLoop> loops;            // 按 well_layout 的路编号
+    WellDemux demux;
+    std::vector<FrameMonitor> monitors;     // 原始流中各井的帧号各自连续，每个井一个；滤波流只有一个
+    bool raw_stream = false;
+    uint64_t frame_no = 0;      // 滤波流不带帧号，有 spike 时取 spike 的帧号，否则按帧递增；原始流直接用帧号
+    bool frame_known = false;   // 滤波流在第一个带 spike 的帧之前不知道真实帧号，不做缺口和滞后检测
+    uint64_t raw_unrouted = 0;  // 原始流中不参与游戏的井的帧
+
+    // 按 well_layout 建各井状态；解码器、检测器和帧期限取 DINO_DECODER_*、DINO_RAW_*、DINO_FRAME_DEADLINE_US
+    void Configure(bool raw);
+
+    // MAXLAB_NO_FRAME：已追上数据流
+    void Empty();
+    void FilteredFrame(StimDispatcher& dispatcher, const maxlab::FilteredFrameData& frame, uint64_t recv_ns);
+    void RawFrame(StimDispatcher& dispatcher, const maxlab::RawFrameData& frame, uint64_t recv_ns);
+};
+
+#endif
@@ -0,0 +1,410 @@
+#include "Analysis.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include "WorkStealingPool.h"
+
+struct StimMark {
+    uint64_t frame;
+    int sequence;   // 读入时为记录中的序列号，整理后为 AnalysisResult::sequence_names 的下标
+};
+
+// 一个会话：按井号整理好的刺激和解码跳跃，以及全部 spike 块
+struct SessionIndex {
+    std::unique_ptr<SessionReader> reader;
+    bool multiwell = false;                 // 有非 0 井的事件时 spike 按井号归属，否则全部归井 0
+    std::vector<StimMark> stims[256];       // 按帧号排序
+    std::vector<uint64_t> jumps[256];       // 解码跳跃的帧号
+    bool seen[256] = {};                    // 有事件的井
+    std::vector<std::string> sequence_names;    // 记录中的序列名，下标为序列号
+    std::vector<const BlockHeader*> spike_blocks;
+};
+
+// 一个任务：一个会话中连续的一段 spike 块，约 chunk_frames 帧
+struct Chunk {
+    size_t session;
+    size_t first_block;
+    size_t end_block;
+};
+
+// 一个工作线程对一个井的部分计数，第一次遇到该井的 spike 时分配
+struct SpikeCounts {
+    std::vector<uint64_t> channel_spikes;
+    std::vector<uint64_t> psth;
+    std::vector<uint64_t> channel_pre;
+    std::vector<uint64_t> channel_post;
+
+    explicit SpikeCounts(uint32_t bins)
+        : channel_spikes(kChannelCount), psth((kAnalysisSequences + 1) * bins),
+          channel_pre(kChannelCount * (kAnalysisSequences + 1)), channel_post(kChannelCount * (kAnalysisSequences + 1)) {}
+};
+
+struct WorkerCounts {
+    std::vector<std::unique_ptr<SpikeCounts>> wells;
+    uint64_t spikes = 0;
+    uint64_t other_well_spikes = 0;
+};
+
+static int DistanceBin(int64_t distance) {
+    if (distance < 0) {
+        return 0;
+    }
+    return distance >= StimPolicy::kMaxDistance ? kDistanceBins - 1 : static_cast<int>(distance / kDistanceBin);
+}
+
+static void AddTo(std::vector<uint64_t>& to, const std::vector<uint64_t>& from) {
+    for (size_t i = 0; i < to.size(); ++i) {
+        to[i] += from[i];
+    }
+}
+
+class Analyser {
+public:
+    Analyser(const AnalysisOptions& options, const StimPolicy& policy, AnalysisResult& result)
+        : options_(options), policy_(policy), result_(result) {
+        std::fill(well_index_, well_index_ + 256, -1);
+        result_.sequence_names.push_back("other");
+    }
+
+    bool Load(const std::string& dir);
+    void Run();
+
+private:
+    int WellIndex(uint8_t well);
+    int SequenceIndex(const SessionIndex& session, int64_t sequence);
+    void IndexEvents(SessionIndex& session);
+    void CountSpikes(const Chunk& chunk, WorkerCounts& counts) const;
+
+    const AnalysisOptions& options_;
+    const StimPolicy& policy_;
+    AnalysisResult& result_;
+    int well_index_[256];                   // 井号 -> result_.wells 下标，超过 kMaxWells 个井后为 -1
+    std::vector<SessionIndex> sessions_;
+    std::vector<Chunk> chunks_;
+};
+
+int Analyser::WellIndex(uint8_t well) {
+    if (well_index_[well] < 0 && result_.wells.size() < kMaxWells) {
+        well_index_[well] = static_cast<int>(result_.wells.size());
+        result_.wells.emplace_back();
+        WellAnalysis& analysis = result_.wells.back();
+        analysis.well = well;
+        analysis.channel_spikes.assign(kChannelCount, 0);
+        analysis.psth.assign((kAnalysisSequences + 1) * options_.Bins(), 0);
+        analysis.channel_pre.assign(kChannelCount * (kAnalysisSequences + 1), 0);
+        analysis.channel_post.assign(kChannelCount * (kAnalysisSequences + 1), 0);
+    }
+    return well_index_[well];
+}
+
+// 会话中的序列号 -> 结果中的下标；按名字合并，序列超过 kAnalysisSequences 个后归入 0
+int Analyser::SequenceIndex(const SessionIndex& session, int64_t sequence) {
+    std::string name;
+    if (sequence >= 1 && static_cast<uint64_t>(sequence) < session.sequence_names.size() &&
+        !session.sequence_names[sequence].empty()) {
+        name = session.sequence_names[sequence];
+    } else if (sequence >= 1 && sequence <= policy_.SequenceCount()) {
+        name = policy_.SequenceName(static_cast<int>(sequence));
+    } else {
+        name = "sequence" + std::to_string(sequence);
+    }
+    std::vector<std::string>& names = result_.sequence_names;
+    for (size_t index = 1; index < names.size(); ++index) {
+        if (names[index] == name) {
+            return static_cast<int>(index);
+        }
+    }
+    if (names.size() > kAnalysisSequences) {
+        return 0;
+    }
+    names.push_back(name);
+    return static_cast<int>(names.size() - 1);
+}
+
+// 事件只有 spike 的千分之一量级，主线程顺序读完
+void Analyser::IndexEvents(SessionIndex& session) {
+    for (const BlockHeader* block : session.reader->Blocks()) {
+        if (block->kind == Block_Spikes) {
+            session.spike_blocks.push_back(block);
+            continue;
+        }
+        if (block->kind != Block_Events) {
+            continue;
+        }
+        const EventColumns events = EventBlockColumns(block);
+        for (uint32_t i = 0; i < block->count; ++i) {
+            const uint8_t well = events.wells[i];
+            const int64_t value = events.values[i];
+            if (well != 0) {
+                session.multiwell = true;
+            }
+            session.seen[well] = true;
+            const int index = WellIndex(well);
+            if (index < 0) {
+                continue;
+            }
+            WellAnalysis& analysis = result_.wells[index];
+            switch (events.types[i]) {
+                case Event_Stim:
+                    // 序列名可能记在后面的块中，读完再换成结果中的下标
+                    session.stims[well].push_back({events.frames[i], static_cast<int>(std::clamp<int64_t>(value, -1, INT_MAX))});
+                    break;
+                case Event_SequenceName:
+                    UnpackSequenceName(value, session.sequence_names);
+                    break;
+                case Event_JumpDecoded:
+                    session.jumps[well].push_back(events.frames[i]);
+                    ++analysis.decoded_jumps[DistanceBin(value)];
+                    break;
+                case Event_Jump:
+                    ++analysis.game_jumps[DistanceBin(value)];
+                    break;
+                case Event_Collision:
+                    ++analysis.collisions;
+                    break;
+                case Event_Score:
+                    ++analysis.games;
+                    analysis.score_sum += static_cast<uint64_t>(value);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    for (int well = 0; well < 256; ++well) {
+        std::vector<StimMark>& stims = session.stims[well];
+        std::vector<uint64_t>& jumps = session.jumps[well];
+        std::sort(stims.begin(), stims.end(), [](const StimMark& a, const StimMark& b) { return a.frame < b.frame; });
+        std::sort(jumps.begin(), jumps.end());
+        for (StimMark& stim : stims) {
+            stim.sequence = SequenceIndex(session, stim.sequence);
+            ++result_.wells[well_index_[well]].stims[stim.sequence];
+        }
+        // 刺激后窗口内的第一个解码跳跃
+        for (const StimMark& stim : stims) {
+            const auto jump = std::lower_bound(jumps.begin(), jumps.end(), stim.frame);
+            if (jump != jumps.end() && *jump < stim.frame + options_.post_frames) {
+                WellAnalysis& analysis = result_.wells[well_index_[well]];
+                ++analysis.evoked_jumps[stim.sequence];
+                analysis.evoked_latency_frames[stim.sequence] += *jump - stim.frame;
+            }
+        }
+    }
+}
+
+bool Analyser::Load(const std::string& dir) {
+    sessions_.emplace_back();
+    SessionIndex& session = sessions_.back();
+    session.reader = std::make_unique<SessionReader>();
+    if (!session.reader->Open(dir)) {
+        sessions_.pop_back();
+        return false;
+    }
+    IndexEvents(session);
+
+    // spike 覆盖的帧数计入会话中每个有事件的井；单井会话即使没有事件也算井 0
+    uint64_t first = UINT64_MAX, last = 0;
+    for (const BlockHeader* block : session.spike_blocks) {
+        first = std::min(first, block->first_frame);
+        last = std::max(last, block->last_frame);
+    }
+    if (!session.multiwell) {
+        WellIndex(0);
+    }
+    if (first <= last) {
+        for (int well = 0; well < 256; ++well) {
+            const bool present = session.multiwell ? session.seen[well] : well == 0;
+            if (present && well_index_[well] >= 0) {
+                result_.wells[well_index_[well]].frames += last - first + 1;
+            }
+        }
+    }
+
+    // 块按写入顺序、帧号大致递增，满 chunk_frames 帧切一个任务
+    const std::vector<const BlockHeader*>& blocks = session.spike_blocks;
+    size_t begin = 0;
+    for (size_t b = 1; b <= blocks.size(); ++b) {
+        if (b == blocks.size() || blocks[b]->first_frame >= blocks[begin]->first_frame + options_.chunk_frames) {
+            chunks_.push_back({sessions_.size() - 1, begin, b});
+            begin = b;
+        }
+    }
+    ++result_.sessions;
+    return true;
+}
+
+void Analyser::CountSpikes(const Chunk& chunk, WorkerCounts& counts) const {
+    const SessionIndex& session = sessions_[chunk.session];
+    const uint32_t bins = options_.Bins();
+    const uint64_t pre = options_.pre_frames;
+    const uint64_t post = options_.post_frames;
+
+    for (size_t b = chunk.first_block; b < chunk.end_block; ++b) {
+        const BlockHeader* block = session.spike_blocks[b];
+        const SpikeColumns columns = SpikeBlockColumns(block);
+        counts.spikes += block->count;
+        for (uint32_t i = 0; i < block->count; ++i) {
+            const uint8_t well = session.multiwell ? columns.wells[i] : 0;
+            const int index = well_index_[well];
+            const uint16_t channel = columns.channels[i];
+            if (index < 0 || channel >= kChannelCount) {
+                ++counts.other_well_spikes;
+                continue;
+            }
+            std::unique_ptr<SpikeCounts>& well_counts = counts.wells[index];
+            if (well_counts == nullptr) {
+                well_counts = std::make_unique<SpikeCounts>(bins);
+            }
+            SpikeCounts& c = *well_counts;
+            ++c.channel_spikes[channel];
+
+            // 与这个 spike 相关的刺激：stim - pre <= frame < stim + post
+            const std::vector<StimMark>& stims = session.stims[well];
+            const uint64_t frame = columns.frames[i];
+            const uint64_t earliest = frame >= post ? frame - post + 1 : 0;
+            auto stim = std::lower_bound(stims.begin(), stims.end(), earliest,
+                                         [](const StimMark& mark, uint64_t f) { return mark.frame < f; });
+            for (; stim != stims.end() && stim->frame <= frame + pre; ++stim) {
+                const uint32_t bin = static_cast<uint32_t>((frame + pre - stim->frame) / options_.bin_frames);
+                if (bin < bins) {
+                    ++c.psth[stim->sequence * bins + bin];
+                }
+                const size_t cell = channel * (kAnalysisSequences + 1) + stim->sequence;
+                if (frame < stim->frame) {
+                    ++c.channel_pre[cell];
+                } else {
+                    ++c.channel_post[cell];
+                }
+            }
+        }
+    }
+}
+
+void Analyser::Run() {
+    WorkStealingPool pool(options_.threads);
+    std::vector<WorkerCounts> workers(pool.Threads());
+    for (WorkerCounts& worker : workers) {
+        worker.wells.resize(result_.wells.size());
+    }
+    pool.Run(chunks_.size(), [&](size_t index, unsigned worker) { CountSpikes(chunks_[index], workers[worker]); });
+
+    for (const WorkerCounts& worker : workers) {
+        result_.spikes += worker.spikes;
+        result_.other_well_spikes += worker.other_well_spikes;
+        for (size_t w = 0; w < worker.wells.size(); ++w) {
+            if (worker.wells[w] == nullptr) {
+                continue;
+            }
+            WellAnalysis& analysis = result_.wells[w];
+            AddTo(analysis.channel_spikes, worker.wells[w]->channel_spikes);
+            AddTo(analysis.psth, worker.wells[w]->psth);
+            AddTo(analysis.channel_pre, worker.wells[w]->channel_pre);
+            AddTo(analysis.channel_post, worker.wells[w]->channel_post);
+        }
+    }
+    result_.chunks = chunks_.size();
+    result_.stolen = pool.Stolen();
+    result_.threads = pool.Threads();
+}
+
+bool AnalyseSessions(const std::vector<std::string>& dirs, const AnalysisOptions& options, const StimPolicy& policy,
+                     AnalysisResult& result) {
+    result = AnalysisResult();
+    if (options.bin_frames == 0 || options.chunk_frames == 0) {
+        fprintf(stderr, "Analysis bin and chunk must be positive\n");
+        return false;
+    }
+    Analyser analyser(options, policy, result);
+    for (const std::string& dir : dirs) {
+        if (!analyser.Load(dir)) {
+            return false;
+        }
+    }
+    analyser.Run();
+    return true;
+}
+
+bool WriteAnalysis(const AnalysisResult& result, const AnalysisOptions& options, const std::string& prefix) {
+    const std::string paths[3] = {prefix + "_channels.csv", prefix + "_psth.csv", prefix + "_jumps.csv"};
+    FILE* files[3] = {};
+    for (int i = 0; i < 3; ++i) {
+        files[i] = fopen(paths[i].c_str(), "w");
+        if (files[i] == nullptr) {
+            fprintf(stderr, "Failed to open %s\n", paths[i].c_str());
+            for (int j = 0; j < i; ++j) {
+                fclose(files[j]);
+            }
+            return false;
+        }
+    }
+    FILE* channels = files[0];
+    FILE* psth = files[1];
+    FILE* jumps = files[2];
+
+    // 只列出至少有一个井出现过的序列
+    std::vector<int> sequences;
+    for (int s = 0; s <= kAnalysisSequences; ++s) {
+        for (const WellAnalysis& well : result.wells) {
+            if (well.stims[s] > 0) {
+                sequences.push_back(s);
+                break;
+            }
+        }
+    }
+
+    const double pre_s = options.pre_frames / 20000.0;
+    const double post_s = options.post_frames / 20000.0;
+    const double bin_s = options.bin_frames / 20000.0;
+    const uint32_t bins = options.Bins();
+
+    fprintf(channels, "well,channel,spikes,rate_hz");
+    for (int s : sequences) {
+        const std::string& name = result.sequence_names[s];
+        fprintf(channels, ",%s_pre_hz,%s_post_hz", name.c_str(), name.c_str());
+    }
+    fputc('\n', channels);
+    fprintf(psth, "well,sequence,name,bin_start_ms,trials,spikes,rate_hz\n");
+    fprintf(jumps, "well,distance_from,distance_to,decoded_jumps,game_jumps\n");
+
+    for (const WellAnalysis& well : result.wells) {
+        const double seconds = well.frames / 20000.0;
+        for (int channel = 0; channel < kChannelCount; ++channel) {
+            const uint64_t spikes = well.channel_spikes[channel];
+            fprintf(channels, "%u,%d,%lu,%.4f", well.well, channel, spikes, seconds > 0 ? spikes / seconds : 0.0);
+            for (int s : sequences) {
+                const size_t cell = channel * (kAnalysisSequences + 1) + s;
+                const double trials = static_cast<double>(well.stims[s]);
+                fprintf(channels, ",%.4f,%.4f", trials > 0 ? well.channel_pre[cell] / (trials * pre_s) : 0.0,
+                        trials > 0 ? well.channel_post[cell] / (trials * post_s) : 0.0);
+            }
+            fputc('\n', channels);
+        }
+        for (int s : sequences) {
+            if (well.stims[s] == 0) {
+                continue;
+            }
+            const std::string& name = result.sequence_names[s];
+            for (uint32_t bin = 0; bin < bins; ++bin) {
+                const uint64_t spikes = well.psth[s * bins + bin];
+                const double start_ms = (static_cast<double>(bin) * options.bin_frames - options.pre_frames) / 20.0;
+                fprintf(psth, "%u,%d,%s,%.2f,%lu,%lu,%.4f\n", well.well, s, name.c_str(), start_ms, well.stims[s], spikes,
+                        spikes / (well.stims[s] * bin_s));
+            }
+        }
+        for (int bin = 0; bin < kDistanceBins; ++bin) {
+            if (bin + 1 < kDistanceBins) {
+                fprintf(jumps, "%u,%d,%d,%lu,%lu\n", well.well, bin * kDistanceBin, (bin + 1) * kDistanceBin,
+                        well.decoded_jumps[bin], well.game_jumps[bin]);
+            } else {
+                fprintf(jumps, "%u,%d,inf,%lu,%lu\n", well.well, bin * kDistanceBin, well.decoded_jumps[bin],
+                        well.game_jumps[bin]);
+            }
+        }
+    }
+    bool ok = true;
+    for (FILE* file : files) {
+        ok = fclose(file) == 0 && ok;
+    }
+    return ok;
+}
@@ -0,0 +1,71 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SessionReader.h"
+#include "SpikeDecoder.h"
+#include "StimPolicy.h"
+#include "Wells.h"
+
+// 离线会话分析：逐通道发放率、按刺激序列对齐的 PSTH、跳跃与障碍物距离的关系。
+// 事件很少，由主线程一次读完；spike 按时间窗切成任务，交给工作窃取线程池，
+// 每个工作线程累加到自己的一份计数，最后合并。多个会话目录的任务放在同一个池里
+
+constexpr int kAnalysisSequences = 16;      // 按序列名编为 1..16，超出的序列计入 0（other）
+constexpr int kDistanceBin = 50;            // 距离直方图的格宽（px）
+constexpr int kDistanceBins = StimPolicy::kMaxDistance / kDistanceBin + 1;     // 最后一格为更远或前方没有障碍物
+
+struct AnalysisOptions {
+    uint32_t pre_frames = 2000;             // PSTH 从刺激前 100 ms 开始
+    uint32_t post_frames = 10000;           // 到刺激后 500 ms
+    uint32_t bin_frames = 200;              // 10 ms 一格
+    uint64_t chunk_frames = 60 * 20000;     // 每个任务约 60 s 的 spike
+    unsigned threads = 0;                   // 0 表示全部硬件线程
+
+    uint32_t Bins() const { return (pre_frames + post_frames + bin_frames - 1) / bin_frames; }
+};
+
+// 一个井的结果；井按所有会话中出现的井号编号
+struct WellAnalysis {
+    uint8_t well = 0;
+    uint64_t frames = 0;                                    // 各会话 spike 覆盖的帧数之和
+    std::vector<uint64_t> channel_spikes;                   // [kChannelCount]
+    uint64_t stims[kAnalysisSequences + 1] = {};            // 按 AnalysisResult::sequence_names 的下标
+    std::vector<uint64_t> psth;                             // [序列][格]，所有通道之和
+    std::vector<uint64_t> channel_pre;                      // [通道][序列]，刺激前窗口内的 spike
+    std::vector<uint64_t> channel_post;                     // [通道][序列]，刺激后窗口内的 spike
+
+    uint64_t evoked_jumps[kAnalysisSequences + 1] = {};     // 刺激后窗口内出现解码跳跃的次数
+    uint64_t evoked_latency_frames[kAnalysisSequences + 1] = {};    // 刺激到第一个解码跳跃的帧数之和
+    uint64_t decoded_jumps[kDistanceBins] = {};             // 解码跳跃时的障碍物距离
+    uint64_t game_jumps[kDistanceBins] = {};                // 游戏中起跳时的障碍物距离（含键盘）
+    uint64_t collisions = 0;
+    uint64_t games = 0;                                     // 有 Event_Score 的局
+    uint64_t score_sum = 0;
+};
+
+struct AnalysisResult {
+    std::vector<WellAnalysis> wells;
+    // 下标 -> 序列名，0 为 other；各会话中同名的序列合并，与会话内的序列号无关
+    std::vector<std::string> sequence_names;
+    uint64_t sessions = 0;
+    uint64_t spikes = 0;
+    uint64_t other_well_spikes = 0;     // 多井会话中不参与游戏的井
+    uint64_t chunks = 0;
+    uint64_t stolen = 0;
+    unsigned threads = 0;
+};
+
+// 打开全部会话目录并分析；打不开的目录打印原因后返回 false。
+// 序列名取自会话记录中的 Event_SequenceName；没有记录序列名的旧会话按 policy 中的编号取名
+bool AnalyseSessions(const std::vector<std::string>& dirs, const AnalysisOptions& options, const StimPolicy& policy,
+                     AnalysisResult& result);
+
+// 结果写成 <prefix>_channels.csv、<prefix>_psth.csv、<prefix>_jumps.csv
+bool WriteAnalysis(const AnalysisResult& result, const AnalysisOptions& options, const std::string& prefix);
+
+#endif
@@ -0,0 +1,85 @@
+#include "AssetPack.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+AssetPack::~AssetPack() {
+    Close();
+}
+
+bool AssetPack::Open(const char* path) {
+    Close();
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(PackHeader))) {
+        close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        perror("mmap asset pack");
+        return false;
+    }
+    base_ = static_cast<const uint8_t*>(mapped);
+    size_ = st.st_size;
+
+    // 头部和目录都校验过再使用，损坏或旧版本的包直接放弃，回退到逐个加载
+    const PackHeader* header = reinterpret_cast<const PackHeader*>(base_);
+    const uint64_t table_end = sizeof(PackHeader) + uint64_t(header->entry_count) * sizeof(PackEntry);
+    bool ok = memcmp(header->magic, kPackMagic, sizeof(kPackMagic)) == 0 && header->version == kPackVersion &&
+              header->file_bytes == size_ && table_end <= size_;
+    entries_ = reinterpret_cast<const PackEntry*>(base_ + sizeof(PackHeader));
+    count_ = ok ? header->entry_count : 0;
+    for (uint32_t i = 0; ok && i < count_; ++i) {
+        const PackEntry& e = entries_[i];
+        ok = e.name[sizeof(e.name) - 1] == '\0' && e.offset % 64 == 0 && e.offset >= table_end &&
+             e.offset + e.bytes <= size_ && uint64_t(e.pitch) * e.height <= e.bytes && e.pitch >= e.width * 4;
+    }
+    if (!ok) {
+        fprintf(stderr, "asset pack %s is invalid\n", path);
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void AssetPack::Close() {
+    if (base_) {
+        munmap(const_cast<uint8_t*>(base_), size_);
+    }
+    base_ = nullptr;
+    size_ = 0;
+    entries_ = nullptr;
+    count_ = 0;
+}
+
+const PackEntry* AssetPack::Find(const char* name) const {
+    for (uint32_t i = 0; i < count_; ++i) {
+        if (strncmp(entries_[i].name, name, sizeof(entries_[i].name)) == 0) {
+            return &entries_[i];
+        }
+    }
+    return nullptr;
+}
+
+const PackEntry* AssetPack::Glyph(const char* font, char c) const {
+    char name[sizeof(PackEntry::name)];
+    snprintf(name, sizeof(name), "%s:%c", font, c);
+    return Find(name);
+}
+
+SDL_Surface* AssetPack::Surface(const PackEntry* entry) const {
+    if (entry == nullptr || entry->width == 0 || entry->height == 0) {
+        return nullptr;
+    }
+    // SDL 只从源 surface 读像素，映射是只读的也没有问题
+    void* pixels = const_cast<uint8_t*>(base_ + entry->offset);
+    return SDL_CreateRGBSurfaceWithFormatFrom(pixels, entry->width, entry->height, 32, entry->pitch, SDL_PIXELFORMAT_RGBA32);
+}
@@ -0,0 +1,104 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+
+// 资源包（*.pak）的二进制布局，由 Dino_bundle 离线生成，游戏启动时 mmap 后直接上传纹理
+//
+//   PackHeader
+//   PackEntry × entry_count
+//   像素数据，每项按 64 字节对齐，格式为 SDL_PIXELFORMAT_RGBA32
+
+constexpr char kPackMagic[8] = {'D', 'I', 'N', 'O', 'P', 'A', 'K', '1'};
+constexpr uint32_t kPackVersion = 1;
+
+struct PackHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_count;
+    uint64_t file_bytes;
+};
+
+enum PackKind : uint32_t {
+    Pack_Image = 1,     // images/ 下的贴图，名字同文件名（不含扩展名）
+    Pack_Glyph = 2,     // 预光栅化的字符，名字为 "<字体>:<字符>"
+    Pack_Text = 3,      // 整段预渲染的文字
+};
+
+struct PackEntry {
+    char name[32];
+    uint32_t kind;
+    uint32_t width;
+    uint32_t height;
+    uint32_t pitch;
+    int32_t advance;        // 字符步进，非字符为 0
+    int32_t line_height;    // 字体行高，非字符为 0
+    uint64_t offset;        // 像素数据相对文件开头的偏移
+    uint64_t bytes;
+};
+
+constexpr uint64_t AlignPack(uint64_t bytes) {
+    return (bytes + 63) & ~uint64_t(63);
+}
+
+// 资源清单，打包工具和游戏的回退加载共用；图片顺序与 SpriteId 一致
+struct ImageAsset {
+    const char* name;
+    const char* path;
+};
+
+constexpr ImageAsset kImageAssets[] = {
+    {"Blinking", "images/Blinking.png"},
+    {"Birds", "images/Birds.png"},
+    {"Cloud", "images/Cloud.png"},
+    {"Crouching", "images/Crouching.png"},
+    {"Dino_menu", "images/Dino_menu.png"},
+    {"Hit", "images/Hit.png"},
+    {"Restart", "images/Restart.png"},
+    {"Road", "images/Road.png"},
+    {"Running", "images/Running.png"},
+    {"Obstacle_a", "images/Obstacle_a.png"},
+    {"Obstacle_b", "images/Obstacle_b.png"},
+    {"Obstacle_c", "images/Obstacle_c.png"},
+    {"Obstacle_d", "images/Obstacle_d.png"},
+    {"Obstacle_e", "images/Obstacle_e.png"},
+    {"Obstacle_f", "images/Obstacle_f.png"},
+    {"Obstacle_g", "images/Obstacle_g.png"},
+};
+constexpr int kImageAssetCount = sizeof(kImageAssets) / sizeof(kImageAssets[0]);
+
+constexpr const char* kScoreFontPath = "fonts/KodeMono-VariableFont_wght.ttf";
+constexpr int kScoreFontSize = 32;
+constexpr const char* kScoreCharset = "0123456789HI ";
+constexpr const char* kGameoverFontPath = "fonts/CHILLER.TTF";
+constexpr int kGameoverFontSize = 90;
+constexpr const char* kGameoverText = "G A M E  O V E R";
+constexpr SDL_Color kTextColor = {0, 0, 0, 0};      // 与 Score_Color / Gameover_Color 的初值一致
+
+// 只读映射一个资源包；Surface() 返回的 surface 直接引用映射内存，不复制像素
+class AssetPack {
+public:
+    AssetPack() = default;
+    ~AssetPack();
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool Open(const char* path);
+    void Close();
+    bool IsOpen() const { return base_ != nullptr; }
+
+    const PackEntry* Find(const char* name) const;
+    const PackEntry* Glyph(const char* font, char c) const;
+    SDL_Surface* Surface(const PackEntry* entry) const;     // 用 SDL_FreeSurface 释放，像素仍属于映射
+    SDL_Surface* Surface(const char* name) const { return Surface(Find(name)); }
+
+private:
+    const uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+    const PackEntry* entries_ = nullptr;
+    uint32_t count_ = 0;
+};
+
+#endif
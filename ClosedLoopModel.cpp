@@ -0,0 +1,69 @@
+#include "ClosedLoopModel.h"
+#include <cmath>
+
+void ClosedLoopModel::Reset() {
+    timer_ = false;
+    due_ = 0;
+    reset_isi_ = true;
+    once_band_ = -1;
+}
+
+bool ClosedLoopModel::Evaluate(const StimPolicy& policy, int distance, uint64_t frame, double isi_scale, int& sequence) {
+    const PolicyEntry& entry = policy.Lookup(distance);
+
+    if (entry.immediate) {
+        if (reset_isi_) {
+            due_ = frame;
+            reset_isi_ = false;
+        }
+    } else {
+        reset_isi_ = true;
+    }
+    if (entry.band != once_band_) {
+        once_band_ = -1;
+    }
+
+    if (timer_ && due_ > frame) {
+        return false;
+    }
+    timer_ = false;
+    if (entry.band < 0 || entry.band == once_band_) {
+        return false;
+    }
+    sequence = entry.sequence;
+    if (entry.once) {
+        once_band_ = entry.band;
+    }
+    if (entry.isi_mode != Isi_None) {
+        const double isi = policy.IsiFrames(entry, distance) * isi_scale;
+        due_ = frame + (isi < 1.0 ? 1 : static_cast<uint64_t>(std::llround(isi)));
+        timer_ = true;
+    }
+    return true;
+}
+
+bool ClosedLoopModel::Decode(SpikeDecoder& decoder, const maxlab::SpikeEvent* spikes, size_t count, uint64_t until) const {
+    bool decoded = false;
+    for (size_t i = 0; i < count;) {
+        size_t j = i;
+        while (j < count && spikes[j].frameNo == spikes[i].frameNo) {
+            ++j;
+        }
+        if (decoder.Update(spikes[i].frameNo, &spikes[i], j - i)) {
+            if (Blanked(spikes[i].frameNo)) {
+                decoder.Rearm();
+            } else {
+                decoded = true;
+            }
+        }
+        i = j;
+    }
+    if (decoder.Update(until, nullptr, 0)) {
+        if (Blanked(until)) {
+            decoder.Rearm();
+        } else {
+            decoded = true;
+        }
+    }
+    return decoded;
+}
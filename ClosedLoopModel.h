@@ -0,0 +1,33 @@
+#ifndef CLOSED_LOOP_MODEL_H
+#define CLOSED_LOOP_MODEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "SpikeDecoder.h"
+#include "StimPolicy.h"
+
+// 采集线程中"按距离评估刺激 → 刺激后空白期 → 解码"的 tick 级模型，扫参和回放共用。
+// 与采集线程的区别：刺激只在调用 Evaluate 的 tick 边界发出，ISI 误差不超过一个 tick。
+class ClosedLoopModel {
+public:
+    void Reset();
+
+    // 每个 tick 调用一次，需要发出刺激时返回 true，sequence 为序列号
+    bool Evaluate(const StimPolicy& policy, int distance, uint64_t frame, double isi_scale, int& sequence);
+
+    // 刺激定时器未到期时不解码；与采集线程一致，到期前的最后一帧参与解码
+    bool Blanked(uint64_t frame) const { return timer_ && due_ > frame + 1; }
+
+    // 把一段 spike 按帧号分组送入解码器，最后在 until 处滚动窗口再判定一次（期间没有 spike 时
+    // 窗口计数仍可能变化）；空白期外任一次越过阈值即返回 true，空白期内越过的留到空白期后再判定。
+    // spike 帧号须不大于 until
+    bool Decode(SpikeDecoder& decoder, const maxlab::SpikeEvent* spikes, size_t count, uint64_t until) const;
+
+private:
+    bool timer_ = false;    // 是否有待评估的刺激定时器
+    uint64_t due_ = 0;
+    bool reset_isi_ = true;
+    int once_band_ = -1;
+};
+
+#endif
@@ -5,25 +5,16 @@
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_mixer.h>
 #include <cmath>
+#include <cstring>
 
 #include <climits> // 添加这个头文件以确保 INT_MAX 被正确定义
 
 #include <unistd.h>
 //#include "events.hpp"
 #include "maxlab/include/maxlab/maxlab.h"
-
-int calculateDistance(SDL_Rect dino, struct use *obstacles) {
-    int min_distance = INT_MAX;
-    for (int i = 0; i < 3; i++) {
-        if (obstacles[i].Obstacle_i > -1) { // if the obstacle is valid
-            int distance = obstacles[i].Rect->x - (dino.x + dino.w);
-            if (distance < min_distance&&distance>0) {
-                min_distance = distance;
-            }
-        }
-    }
-    return min_distance;
-}
+#include "Trace.h"
+#include "ThreadTuning.h"
+#include "Acquisition.h"
 
 void message_thread(){
 //    if (argc < 2) {
@@ -32,91 +23,55 @@ void message_thread(){
 //    }
 //    const int detection_channel = atoi(argv[1]);
 
+    // 线程绑核与实时优先级：DINO_ACQ_CPU / DINO_ACQ_FIFO
+    ApplyThreadPolicy("acquisition", ThreadPolicyFromEnv("ACQ"));
+    FrameWaiter waiter = FrameWaiterFromEnv();
+    const uint64_t thread_start_ns = MonotonicNs();
+
     maxlab::checkVersions();
-    maxlab::verifyStatus(maxlab::DataStreamerFiltered_open(maxlab::FilterType::IIR));
-    printf("thread\n");
 
-    uint64_t isi = 0;
-    
+    // DINO_ACQ=raw 时接原始流，在本机做带通滤波和阈值检测；默认用 mxwserver 滤波后的 spike 流
+    const char* acq_mode = getenv("DINO_ACQ");
+    const bool raw_stream = acq_mode != nullptr && strcmp(acq_mode, "raw") == 0;
+    AcquisitionLoop acquisition;
+    acquisition.Configure(raw_stream);
+    const int well_count = well_layout.count;
+    // sendSequence 和出错时的 get_errors 都在刺激线程上，采集线程只入队
+    StimDispatcher dispatcher;
+    dispatcher.Start(ThreadPolicyFromEnv("STIM"));
+
+    maxlab::RawFrameData rawFrame;
     maxlab::FilteredFrameData frameData;
-    int distance;
-    
+    if (raw_stream) {
+        maxlab::verifyStatus(maxlab::DataStreamerRaw_open());
+    } else {
+        maxlab::verifyStatus(maxlab::DataStreamerFiltered_open(maxlab::FilterType::IIR));
+    }
+    printf("thread\n");
+
+    AcquisitionMetrics& acq_metrics = metrics.Data().acquisition;
 
-    bool reset_isi=true;
-    bool reset_sti=true;
     //printf("stop_thread=%d\n",stop_thread.load());
     while (!stop_thread) {
 
-        distance = calculateDistance(TheDINO_Rect[0], Obstacle_Use);
-        printf("distance(thread): %d\n", distance);
-
-        maxlab::Status status = maxlab::DataStreamerFiltered_receiveNextFrame(&frameData);
-        if (status == maxlab::Status::MAXLAB_NO_FRAME)
+        maxlab::Status status = raw_stream ? maxlab::DataStreamerRaw_receiveNextFrame(&rawFrame)
+                                           : maxlab::DataStreamerFiltered_receiveNextFrame(&frameData);
+        if (status == maxlab::Status::MAXLAB_NO_FRAME) {
+            Bump(acq_metrics.empty_polls);
+            acquisition.Empty();
+            waiter.Idle();
             continue;
-
-
-        printf("isi(thread):%d\n",isi);
-
-        if(distance<=200&&distance>194) {       //当距离在这个区间时，需要立即给出刺激，所以将isi置0，reset_isi 保证只会置0一次
-            if (reset_isi) {          //防止发送过多序列
-                    isi = 0;
-                    reset_isi = false; // 重置后，将reset_blanking设为false
-                }
         }
-        else{
-                reset_isi = true;    //允许重置isi
+        waiter.Received();
+        const uint64_t recv_ns = MonotonicNs();
+        Bump(acq_metrics.frames);
+
+        if (raw_stream) {
+            acquisition.RawFrame(dispatcher, rawFrame, recv_ns);
+        } else {
+            acquisition.FilteredFrame(dispatcher, frameData, recv_ns);
         }
 
-        if(isi == 0){
-            if(distance>1500 ) {
-                const maxlab::Status status = maxlab::sendSequence("close_loop1");
-                isi = 2000 * 20;
-            }
-            else if(distance<=1500&&distance>200 ) {
-                const maxlab::Status status = maxlab::sendSequence("close_loop1");
-                isi = static_cast<uint64_t>(distance * 20) ;
-            }
-            else if(distance<=200&&distance>120){
-                const maxlab::Status status = maxlab::sendSequence("close_loop1");
-                isi = (120) * 20;   //100*100/200=50ms
-            }
-            else if(distance<=120 && distance>80){
-                if (reset_sti) { 
-                    const maxlab::Status status = maxlab::sendSequence("close_loop2");
-                    reset_sti = false; 
-                } 
-            }
-            else reset_sti = true;
-
-
-
-            if (status != maxlab::Status::MAXLAB_OK) {
-              maxlab::Response response = maxlab::sendRaw("get_errors");
-              fprintf(stderr, "An error occured: %s\n", response.content);
-              maxlab::freeResponse(&response);
-            }
-        }
-
-
-        spikes_count = frameData.spikeCount;
-
-
-        if(isi > 0){
-            --isi;
-            if (isi != 0)
-                continue;
-        }
-
-
-
-        if(spikes_count>=10){
-            printf("spike count(thread): %d\n", spikes_count.load());
-            jump = 1;
-            //blanking = 20000;  //2000 samples,100ms
-        }
-
-        printf("jump(thread)=%d\n",jump.load());
-
     //        for (int i = 0; i < frameData.spikeCount; ++i) {
     //            const maxlab::SpikeEvent &spike = frameData.spikeEvents[i];
     //            if (spike.channel == detection_channel) {
@@ -132,7 +87,49 @@ void message_thread(){
     //            }
     //        }
     }
-    maxlab::verifyStatus(maxlab::DataStreamerFiltered_close());
+    dispatcher.Stop();
+    std::vector<WellLoop>& loops = acquisition.loops;
+    std::vector<FrameMonitor>& monitors = acquisition.monitors;
+    if (raw_stream) {
+        maxlab::verifyStatus(maxlab::DataStreamerRaw_close());
+        uint64_t detected = 0;
+        for (const WellLoop& loop : loops) {
+            detected += loop.raw_detector->Detected();
+        }
+        printf("raw detector: spikes=%lu\n", detected);
+    } else {
+        maxlab::verifyStatus(maxlab::DataStreamerFiltered_close());
+    }
+
+    const double seconds = (MonotonicNs() - thread_start_ns) / 1e9;
+    // frames 为实际收到的帧数；last_frame 为最后处理的帧号（滤波流取自 spike，原始流为最后一帧所在井的硬件帧号）
+    printf("acquisition: frames=%lu last_frame=%lu empty_polls=%lu (%.0f/s) sleeps=%lu\n",
+           acq_metrics.frames.load(std::memory_order_relaxed), acquisition.frame_no, waiter.EmptyPolls(),
+           seconds > 0 ? waiter.EmptyPolls() / seconds : 0.0, waiter.Sleeps());
+    for (int slot = 0; slot < well_count; ++slot) {
+        printf("stim scheduler (well %u): fired=%lu late_frames=%lu\n", well_layout.ids[slot],
+               loops[slot].scheduler->Fired(), loops[slot].scheduler->LateFrames());
+    }
+    if (raw_stream) {
+        for (int slot = 0; slot < well_count; ++slot) {
+            char name[32];
+            snprintf(name, sizeof(name), "stream (well %u)", well_layout.ids[slot]);
+            monitors[slot].Print(stdout, name);
+        }
+    } else {
+        monitors[0].Print(stdout, "stream");
+    }
+    for (int slot = 0; slot < well_count; ++slot) {
+        char name[16];
+        snprintf(name, sizeof(name), "well %u", well_layout.ids[slot]);
+        well_links[slot].response.Print(stdout, name, *stim_policies.Current());
+    }
+    printf("stim dispatcher: sent=%lu failed=%lu merged=%lu dropped=%lu discarded=%lu\n", dispatcher.Sent(),
+           dispatcher.Failed(), dispatcher.Merged(), dispatcher.Dropped(), dispatcher.Discarded());
+    if (well_layout.demux) {
+        printf("wells: %d, spikes from other wells=%lu, raw frames from other wells=%lu\n",
+               well_count, acquisition.demux.Unrouted(), acquisition.raw_unrouted);
+    }
 
 
 }
@@ -142,6 +139,16 @@ void message_thread(){
 
 
 DinoGame::DinoGame() {
+    tick_recv_ns.reserve(well_links[0].decoder_events.Capacity());
+
+    // 第 0 路用全局 game_state，其余各路的状态放在 background_states 中
+    background_states.resize(well_layout.count - 1);
+    wells.resize(well_layout.count);
+    for (int slot = 0; slot < well_layout.count; ++slot) {
+        wells[slot].slot = slot;
+        wells[slot].well = well_layout.ids[slot];
+        wells[slot].state = slot == 0 ? &game_state : &background_states[slot - 1];
+    }
     renderer.Initialize("MY DINO", Width_Window, Height_Window);
     
     Load();  // 加载资源
@@ -154,29 +161,32 @@ DinoGame::~DinoGame() {
 }
 
 void DinoGame::Load() {
-    // 加载字体
-    Score_Font = TTF_OpenFont("fonts/KodeMono-VariableFont_wght.ttf", 32);
-    if(Score_Font==nullptr) std::cout << "Score_Font Failed"<<std::endl;    
-    Gameover_Font = TTF_OpenFont("fonts/CHILLER.TTF", 90);
-    if(Gameover_Font==nullptr) std::cout << "Gameover_Font Failed"<<std::endl;
-
-
-    // 加载图片资源
-    Blinking_Surface = IMG_Load("images/Blinking.png");
-    Birds_Surface = IMG_Load("images/Birds.png");
-    Cloud_Surface = IMG_Load("images/Cloud.png");
-    Crouching_Surface = IMG_Load("images/Crouching.png");
-    Dino_menu_Surface = IMG_Load("images/Dino_menu.png");
-    Hit_Surface = IMG_Load("images/Hit.png");
-    Restart_Surface = IMG_Load("images/Restart.png");
-    Road_Surface = IMG_Load("images/Road.png");
-    Running_Surface = IMG_Load("images/Running.png"); 
-
-    if(Running_Surface==nullptr) std::cout << "Running_Surface Failed"<<std::endl;
-
-    // 加载障碍物资源
-    for (int i = 0; i < 7; ++i) {
-        Obstacle_Surface[i] = IMG_Load(("images/Obstacle_" + std::string(1, 'a' + i) + ".png").c_str());
+    // 优先 mmap 预先打包好的资源（Dino_bundle 生成），像素不再解码也不复制；DINO_ASSET_PACK 指定路径
+    const char* pack_path = getenv("DINO_ASSET_PACK");
+    if (assets.Open(pack_path ? pack_path : "assets.pak")) {
+        for (int i = 0; i < kImageAssetCount; ++i) {
+            sprites[i] = assets.Surface(kImageAssets[i].name);
+        }
+        sprites[Sprite_Gameover] = assets.Surface("gameover");
+        std::cout << "Assets loaded from pack" << std::endl;
+    } else {
+        // 加载字体
+        Score_Font = TTF_OpenFont(kScoreFontPath, kScoreFontSize);
+        if(Score_Font==nullptr) std::cout << "Score_Font Failed"<<std::endl;
+        Gameover_Font = TTF_OpenFont(kGameoverFontPath, kGameoverFontSize);
+        if(Gameover_Font==nullptr) std::cout << "Gameover_Font Failed"<<std::endl;
+
+        // 加载图片资源，顺序与 SpriteId 一致
+        for (int i = 0; i < kImageAssetCount; ++i) {
+            sprites[i] = IMG_Load(kImageAssets[i].path);
+        }
+
+        // 渲染“Game Over”字体
+        sprites[Sprite_Gameover] = TTF_RenderUTF8_Blended(Gameover_Font, kGameoverText, Gameover_Color);
+    }
+
+    for (int i = 0; i < SpriteCount; ++i) {
+        if (sprites[i] == nullptr) std::cout << "Sprite " << i << " Failed" << std::endl;
     }
 
     // // 加载背景音乐
@@ -187,83 +197,76 @@ void DinoGame::Load() {
 }
 
 void DinoGame::PrepareAll() {
-    // 创建窗口和渲染器，并准备纹理资源
-    renderer.LoadTexture("images/Blinking.png", Blinking_Texture, TheDINO_Rect[0]);
-    renderer.LoadTexture("images/Birds.png", Birds_Texture, Birds_Rect[0]);
-    renderer.LoadTexture("images/Cloud.png", Cloud_Texture, Cloud_Rect[0]);
-    renderer.LoadTexture("images/Crouching.png", Crouching_Texture, TheDINO_Rect[1]);
-    renderer.LoadTexture("images/Dino_menu.png", Dino_menu_Texture, Dino_menu_Rect);
-    renderer.LoadTexture("images/Hit.png", Hit_Texture, Hit_Rect);
-    renderer.LoadTexture("images/Restart.png", Restart_Texture, Restart_Rect);
-    renderer.LoadTexture("images/Road.png", Road_Texture, Road_Rect[0]);
-    renderer.LoadTexture("images/Running.png", Running_Texture, running_rect[0]);
+    // 所有贴图和分数字符拼成一张图集纹理，surface 上传后即释放，之后尺寸都从图集取
+    const bool built = assets.IsOpen() ? renderer.BuildAtlas(sprites, assets) : renderer.BuildAtlas(sprites, Score_Font, Score_Color);
+    if (!built) std::cout << "Sprite atlas Failed" << std::endl;
+    for (SDL_Surface*& sprite : sprites) {
+        sprite = nullptr;
+    }
+    assets.Close();
 
-    
+    const SDL_Rect& dino_menu = renderer.SpriteRect(Sprite_DinoMenu);
+    const SDL_Rect& blinking = renderer.SpriteRect(Sprite_Blinking);
+    const SDL_Rect& crouching = renderer.SpriteRect(Sprite_Crouching);
+    const SDL_Rect& running = renderer.SpriteRect(Sprite_Running);
+    const SDL_Rect& road = renderer.SpriteRect(Sprite_Road);
+    const SDL_Rect& cloud = renderer.SpriteRect(Sprite_Cloud);
+    const SDL_Rect& birds = renderer.SpriteRect(Sprite_Birds);
+    const SDL_Rect& hit = renderer.SpriteRect(Sprite_Hit);
+    const SDL_Rect& restart = renderer.SpriteRect(Sprite_Restart);
+    const SDL_Rect& gameover = renderer.SpriteRect(Sprite_Gameover);
 
-    for (int i = 0; i < 7; ++i) {
-        renderer.LoadTexture("images/Obstacle_" + std::string(1, 'a' + i) + ".png", Obstacle_Texture[i], Obstacles_Rect[i]);
-    }
+    Hit_Rect = {0, 0, hit.w, hit.h};
 
-    // 渲染“Game Over”字体
-    Gameover_Surface = TTF_RenderUTF8_Blended(Gameover_Font, "G A M E  O V E R", Gameover_Color);
-    if(Gameover_Surface==nullptr) std::cout << "Gameover_Surface Failed"<<std::endl;
-    Gameover_Texture = SDL_CreateTextureFromSurface(renderer.GetRenderer(), Gameover_Surface);
-    
     // 确定 Dino 矩形区域
-    Dino_menu_Rect = {50, Height_Window - 120, Dino_menu_Surface->w, Dino_menu_Surface->h};
-    TheDINO_Rect[0] = {Dino_menu_Rect.x + 4, Dino_menu_Rect.y, Blinking_Surface->w, Blinking_Surface->h};
-    TheDINO_Rect[1] = {Dino_menu_Rect.x + 4, Dino_menu_Rect.y + 34, Crouching_Surface->w, Crouching_Surface->h / 2};
+    Dino_menu_Rect = {50, Height_Window - 120, dino_menu.w, dino_menu.h};
+    GameGeometry& geo = game_geometry;
+    geo.dino_menu = {Dino_menu_Rect.x, Dino_menu_Rect.y, Dino_menu_Rect.w, Dino_menu_Rect.h};
+    geo.dino[0] = {Dino_menu_Rect.x + 4, Dino_menu_Rect.y, blinking.w, blinking.h};
+    geo.dino[1] = {Dino_menu_Rect.x + 4, Dino_menu_Rect.y + 34, crouching.w, crouching.h / 2};
 
-    // 设置跑道
-    Road_Rect[0] = {0, Dino_menu_Rect.y + Dino_menu_Rect.h - 24, Road_Surface->w, Road_Surface->h};
-    Road_Rect[1] = {Road_Surface->w, Dino_menu_Rect.y + Dino_menu_Rect.h - 24, Road_Surface->w, Road_Surface->h};
-    
-    // 云的矩形区域
-    Cloud_Rect[0] = {static_cast<int>(0.11 * Width_Window), static_cast<int>(0.29 * Height_Window), Cloud_Surface->w, Cloud_Surface->h};
-    Cloud_Rect[1] = {static_cast<int>(0.36 * Width_Window), static_cast<int>(0.23 * Height_Window), Cloud_Surface->w, Cloud_Surface->h};
-    Cloud_Rect[2] = {static_cast<int>(0.61 * Width_Window), static_cast<int>(0.37 * Height_Window), Cloud_Surface->w, Cloud_Surface->h};
-    Cloud_Rect[3] = {static_cast<int>(0.89 * Width_Window), static_cast<int>(0.21 * Height_Window), Cloud_Surface->w, Cloud_Surface->h};
+    // 跑道和云
+    geo.road = {0, Dino_menu_Rect.y + Dino_menu_Rect.h - 24, road.w, road.h};
+    geo.cloud = {0, 0, cloud.w, cloud.h};
 
     // 设置障碍物矩形区域
     for (int i = 0; i < 7; ++i) {
-        Obstacles_Rect[i] = {0, Road_Rect[0].y - Obstacle_Surface[i]->h + 22, Obstacle_Surface[i]->w, Obstacle_Surface[i]->h};
+        const SDL_Rect& obstacle = renderer.SpriteRect(Sprite_Obstacle + i);
+        Obstacles_Rect[i] = {0, geo.road.y - obstacle.h + 22, obstacle.w, obstacle.h};
+        geo.obstacles[i] = {Obstacles_Rect[i].x, Obstacles_Rect[i].y, Obstacles_Rect[i].w, Obstacles_Rect[i].h};
+    }
+    // 鸟的两帧上下排列，高度在站立恐龙的头部，蹲下可以躲过
+    for (int i = 0; i < 2; ++i) {
+        birds_rect[i] = {0, birds.h / 2 * i, birds.w, birds.h / 2};
+        Birds_Rect[i] = {0, geo.road.y - 120, birds.w, birds.h / 2};
+        geo.birds[i] = {Birds_Rect[i].x, Birds_Rect[i].y, Birds_Rect[i].w, Birds_Rect[i].h};
     }
+    geo.min_interval_half = MinInterval_Half;
+    geo.spawn_spacing = Width_Window / 2;
+    geo.bird_percent = 0;
+    GameDifficultyFromEnv(geo);
+
+    // 菜单和开场动画也使用游戏状态中的位置
+    GameReset(game_state, game_geometry);
 
     for (int i = 0; i < 2; i++)
     {
-        running_rect[i] = (SDL_Rect){ 0,Running_Surface->h / 2 * i,Running_Surface->w ,Running_Surface->h / 2 };
-        crouching_rect[i] = (SDL_Rect){ 0,Crouching_Surface->h / 2 * i,Crouching_Surface->w,Crouching_Surface->h / 2 };
+        running_rect[i] = (SDL_Rect){ 0,running.h / 2 * i,running.w ,running.h / 2 };
+        crouching_rect[i] = (SDL_Rect){ 0,crouching.h / 2 * i,crouching.w,crouching.h / 2 };
     }
 
     // 设置“Game Over”和“Restart”按钮的矩形区域
-    Gameover_Rect = {(Width_Window - Gameover_Surface->w) / 2, Height_Window / 4, Gameover_Surface->w, Gameover_Surface->h};
-    Restart_Rect = {(Width_Window - Restart_Surface->w) / 2, Gameover_Rect.y + Gameover_Surface->h + 5, Restart_Surface->w, Restart_Surface->h};
+    Gameover_Rect = {(Width_Window - gameover.w) / 2, Height_Window / 4, gameover.w, gameover.h};
+    Restart_Rect = {(Width_Window - restart.w) / 2, Gameover_Rect.y + gameover.h + 5, restart.w, restart.h};
     
 }
 
 void DinoGame::Set() {
-    // 初始化游戏状态和随机数
-    srand(static_cast<unsigned int>(time(nullptr)));
-
-    jump = false;
-    down = false;
-    crouch = false;
-    collision = false;
-    j = 0;
-    life = 4;
-    rate = 1.0;
-    score_m = 0;
-    r = 4111;
-    
-    for (int i = 0; i < 3; ++i) {
-        r_bird[i] = 2147516415;
-    }
-
-    TheDINO_Rect[0].y = Dino_menu_Rect.y;
-    std_ = Dino_menu_Rect.y;
+    StartGame(wells[0]);
 
-    for (int i = 0; i < 3; ++i) {
-        Obstacle_Use[i] = { -1, Width_Window / 2 * (i + 2), false };
+    // 两局之间检查刺激策略文件，修改过则换上新表，数据流不中断
+    if (stim_policies.Reload(StimPolicyPath())) {
+        RecordSequenceNames();
     }
 
     // 更新最高分数显示
@@ -277,9 +280,88 @@ void DinoGame::Set() {
     std::cout << "Set Parameter" <<std::endl;
 }
 
+void DinoGame::StartGame(WellGame& game) {
+    // 初始化游戏状态和随机数，种子写入会话记录供回放
+    const uint64_t seed = session_seed + game.games_started++;
+    GameSeed(*game.state, seed);
+    game.tick_no = 0;
+    recorder.AppendEvent(Lane_Game, Event_Seed, acq_frame.load(std::memory_order_relaxed), static_cast<int64_t>(seed), game.well);
+
+    // 丢弃上一局遗留的解码事件
+    WellLink& link = well_links[game.slot];
+    DecoderEvent stale;
+    while (link.decoder_events.Pop(stale)) {
+    }
+
+    GameReset(*game.state, game_geometry);
+    game.last_distance = calculateDistance(*game.state);
+    link.obstacle_distance.store(game.last_distance, std::memory_order_relaxed);
+
+    WellMetrics& well_metrics = metrics.Data().well[game.slot];
+    Bump(well_metrics.games);
+    Gauge(well_metrics.score, 0);
+    Gauge(well_metrics.distance, static_cast<uint64_t>(game.last_distance));
+}
+
+// 一个井的一个 tick：取空该井的解码事件、记录输入、推进游戏并做碰撞检测
+void DinoGame::TickWell(WellGame& game, GameInput& input) {
+    GameState& state = *game.state;
+    WellLink& link = well_links[game.slot];
+
+    // 取空解码事件队列，两个 tick 之间到达的每个事件都会被处理
+    const bool key_jump = input.jump;
+    const bool decoded_jump = DrainDecoderEvents(game.slot, input);
+
+    // 每个 tick 记一条输入，回放按 tick 序号逐条施加
+    const uint8_t bits = (key_jump ? Input_KeyJump : 0) | (decoded_jump ? Input_DecodedJump : 0) | (input.down ? Input_Down : 0);
+    recorder.AppendEvent(Lane_Game, Event_Input, acq_frame.load(std::memory_order_relaxed), static_cast<int64_t>(game.tick_no << 8 | bits), game.well);
+    ++game.tick_no;
+
+    const bool was_jumping = state.jump;
+    GameStep(state, game_geometry, input);
+    input.jump = false;
+
+    // 障碍物越过 200 px 的时刻，供采集线程计算刺激延迟
+    int distance = calculateDistance(state);
+    link.obstacle_distance.store(distance, std::memory_order_relaxed);
+    if (state.jump && !was_jumping) {
+        recorder.AppendEvent(Lane_Game, Event_Jump, acq_frame.load(std::memory_order_relaxed), distance, game.well);
+    }
+    if (distance <= 200 && game.last_distance > 200) {
+        link.cross_ns.store(MonotonicNs(), std::memory_order_relaxed);
+    }
+    game.last_distance = distance;
+
+    // 碰撞检测
+    CD(game);
+
+    WellMetrics& well_metrics = metrics.Data().well[game.slot];
+    Gauge(well_metrics.score, state.score_m / 5);
+    Gauge(well_metrics.distance, static_cast<uint64_t>(distance));
+}
+
+void DinoGame::FinishGame(WellGame& game) {
+    const unsigned long score = game.state->score_m / 5;
+    recorder.AppendEvent(Lane_Game, Event_Score, acq_frame.load(std::memory_order_relaxed), score, game.well);
+    RecordGameEnd(game);
+    if (score > game.best_score) {
+        game.best_score = score;
+        Gauge(metrics.Data().well[game.slot].best_score, score);
+    }
+    printf("well %u game %lu score %lu\n", game.well, game.games_started - 1, score);
+    if (game.slot == 0) {
+        if (score > highestscore) {
+            highestscore = score;
+        }
+        Set();
+    } else {
+        StartGame(game);
+    }
+}
+
 void DinoGame::Jump() {
     // 记录恐龙初始的纵坐标
-    double t = TheDINO_Rect[0].y;
+    double t = game_state.dino[0].y;
 
     // 进行跳跃动画的循环
     for (int i = 0; i < 2 * V * Tan + 1; i++)
@@ -287,17 +369,17 @@ void DinoGame::Jump() {
         // 计算跳跃位置的变化
         t += (i - V * Tan) * 2 * Height_Window / (double)(3 * V * Tan * V * Tan);
 
-        // 更新 TheDINO_Rect[0] 的纵坐标
-        TheDINO_Rect[0].y = t;
+        // 更新恐龙的纵坐标
+        game_state.dino[0].y = t;
 
         // 清空渲染目标
         renderer.Clear();
 
         // 绘制恐龙纹理
-        renderer.RenderTexture(Blinking_Texture, NULL, TheDINO_Rect);
+        renderer.RenderSprite(Sprite_Blinking, NULL, game_state.dino[0]);
 
         // 绘制道路纹理
-        renderer.RenderTexture(Road_Texture, NULL, Road_Rect);
+        renderer.RenderSprite(Sprite_Road, NULL, game_state.road[0]);
 
         // 更新渲染目标
         renderer.Present();
@@ -305,33 +387,83 @@ void DinoGame::Jump() {
         // 延迟，控制动画速度
         SDL_Delay(1000 / mFPS);
     }
-    TheDINO_Rect->y = Dino_menu_Rect.y;
+    game_state.dino[0].y = game_geometry.dino_menu.y;
 }
 
 void DinoGame::Play() {
 
+    // 跟踪日志：DINO_TRACE=0/1/2 选择级别，DINO_TRACE_FILE 指定输出文件（.bin 为二进制）
+    if (const char* level = getenv("DINO_TRACE")) {
+        trace_level = atoi(level);
+    }
+    TraceStart(getenv("DINO_TRACE_FILE"));
+
+    // 会话记录：DINO_RECORD_DIR 指定目录，DINO_RECORD_SEGMENT_MB 指定单个段文件大小
+    if (const char* dir = getenv("DINO_RECORD_DIR")) {
+        const char* mb = getenv("DINO_RECORD_SEGMENT_MB");
+        const uint64_t segment_mb = mb ? strtoull(mb, nullptr, 10) : 256;
+        if (!recorder.Start(dir, segment_mb << 20)) {
+            std::cerr << "Failed to start recorder in " << dir << std::endl;
+        }
+        // 几何由贴图尺寸决定，按 GeometryField 的编号逐项写入，回放时不需要贴图
+        GameGeometry geometry = game_geometry;
+        for (int i = 0; i < kGeometryFields; ++i) {
+            recorder.AppendEvent(Lane_Game, Event_Geometry, 0,
+                                 static_cast<int64_t>(i) << 32 | static_cast<uint32_t>(*GeometryField(geometry, i)));
+        }
+    }
+    printf("session seed %lu (DINO_SEED to reproduce)\n", session_seed);
+
+    // 运行时计数器：DINO_METRICS 指定共享内存名，Dino_dash 读取
+    if (metrics.Open(MetricsNameFromEnv(), well_layout)) {
+        printf("metrics in shared memory %s\n", MetricsNameFromEnv());
+    }
+
+    // 渲染（主）线程：DINO_RENDER_CPU / DINO_RENDER_FIFO
+    ApplyThreadPolicy("render", ThreadPolicyFromEnv("RENDER"));
+
+    // 刺激策略：DINO_STIM_POLICY 指定配置文件，采集线程启动前先加载一次
+    stim_policies.Reload(StimPolicyPath());
+    RecordSequenceNames();
+
+    // 在线 PSTH 在采集线程启动前分配好，之后只由采集线程写
+    const StimResponseConfig response_config = StimResponseConfigFromEnv();
+    for (int slot = 0; slot < well_layout.count; ++slot) {
+        if (!well_links[slot].response.Configure(response_config)) {
+            well_links[slot].response.Configure(StimResponseConfig());
+        }
+    }
+
     std::thread t(message_thread);
     //t.detach();
     printf("start thread\n");
     sleep(1);
 
     Set();
+    for (size_t slot = 1; slot < wells.size(); ++slot) {
+        StartGame(wells[slot]);
+    }
+    if (wells.size() > 1) {
+        printf("%zu wells, window shows well %u; games restart automatically\n", wells.size(), wells[0].well);
+    }
 
     std::cout << "start game" << std::endl;
 
-    bool pause;
-    int blanking = 0;
+    bool pause = false;
+    GameInput input{false, false};
+
+    // 固定步长：DINO_RENDER_FPS 设置后画面与 tick 解耦并插值，见 FramePacer.h
+    GameState previous_state = game_state;
+    pacer.Start();
 
     while (true)
     {
-        clock_t FStartTime = clock();
-        if (SDL_PollEvent(&MainEvent))
+        while (SDL_PollEvent(&MainEvent))
         {
             switch (MainEvent.type)
             {
                 case SDL_QUIT:
-                    stop_thread = true;
-                    t.join();
+                    EndSession(t);
                     return;
                     break;
 
@@ -339,19 +471,18 @@ void DinoGame::Play() {
                     switch (MainEvent.key.keysym.sym)
                     {
                         case SDLK_ESCAPE:
-                            stop_thread = true;
-                            t.join();
+                            EndSession(t);
                             return;
                             break;
 
                         case SDLK_DOWN:
-                            down = true;
+                            input.down = true;
                             break;
 
                         case SDLK_UP:
                         case SDLK_SPACE:
                             std::cout << "space press" << std::endl;
-                            jump = true;
+                            input.jump = true;
                             break;
 
                         case SDLK_p:
@@ -367,8 +498,7 @@ void DinoGame::Play() {
                     switch (MainEvent.key.keysym.sym)
                     {
                         case SDLK_DOWN:
-                            down = false;
-                            crouch = false;
+                            input.down = false;
                             break;
 
                         default:
@@ -381,33 +511,66 @@ void DinoGame::Play() {
             }
         }
 
-        score_m++;
-        //Select Speed
-        if (score_m >= 2500)
-        {
-            rate = 1.25;
-        }
-        else if (score_m >= 10000)
+        // 按墙钟推进若干个 tick，落后时补齐
+        const int ticks = pacer.Advance(game_state.rate);
+        GameMetrics& game_metrics = metrics.Data().game;
+        Gauge(game_metrics.overruns, pacer.Overruns());
+        Gauge(game_metrics.dropped_ticks, pacer.DroppedTicks());
+        for (int tick = 0; tick < ticks && game_state.life >= 0; ++tick)
         {
-            rate = 1.5;
+            previous_state = game_state;
+            TickWell(wells[0], input);
+            Bump(game_metrics.ticks);
+
+            // 多井时窗口中的一局也自动重开，结束画面会让所有井停下
+            if (wells.size() > 1 && game_state.life < 0) {
+                FinishGame(wells[0]);
+                previous_state = game_state;
+            }
         }
 
+        // 后台各井没有键盘输入，同样的墙钟时间按各自的 rate 推进，不跟随第 0 路的分数加速
+        for (size_t slot = 1; slot < wells.size(); ++slot) {
+            WellGame& well = wells[slot];
+            const int well_ticks = well.clock.Advance(pacer.ElapsedNs(), well.state->rate);
+            for (int tick = 0; tick < well_ticks; ++tick) {
+                GameInput background{false, false};
+                TickWell(well, background);
+                if (well.state->life < 0) {
+                    FinishGame(well);
+                }
+            }
+        }
 
         // 渲染场景
-        renderer.Clear();
-        renderer.RenderBackground(Road_Texture, Road_Rect);
-        renderer.RenderObstacle(Obstacle_Surface, Obstacles_Rect, 7);       
-        renderer.RenderDino(Blinking_Texture, TheDINO_Rect);
-        renderer.RenderScore(score_m / 5 % 1000000, Score_Font, Score_Rect);        
-        renderer.Present();
-
-        // 碰撞检测
-        CD();
+        if (pacer.RenderDue())
+        {
+            const uint64_t render_start_ns = MonotonicNs();
+            const GameState frame = GameInterpolate(previous_state, game_state, pacer.Alpha());
+            renderer.Clear();
+            renderer.RenderBackground(frame);
+            renderer.RenderObstacle(frame);
+            renderer.RenderDino(frame);
+            renderer.RenderScore(game_state.score_m / 5 % 1000000, Score_Rect);
+            renderer.Present();
+            RecordPresentLatency();
+            const uint64_t render_ns = MonotonicNs() - render_start_ns;
+            Bump(game_metrics.renders);
+            Bump(game_metrics.render_ns, render_ns);
+            if (render_ns > game_metrics.render_max_ns.load(std::memory_order_relaxed)) {
+                Gauge(game_metrics.render_max_ns, render_ns);
+            }
+        }
 
-        if (life < 0)
+        if (game_state.life < 0)
         {
+            recorder.AppendEvent(Lane_Game, Event_Score, acq_frame.load(std::memory_order_relaxed), game_state.score_m / 5, wells[0].well);
+            if (game_state.score_m / 5 > metrics.Data().well[0].best_score.load(std::memory_order_relaxed)) {
+                Gauge(metrics.Data().well[0].best_score, game_state.score_m / 5);
+            }
+            RecordGameEnd(wells[0]);
             // 调用新的 RenderGameover 函数
-            renderer.RenderGameover(Hit_Texture, Gameover_Texture, Restart_Texture, Hit_Rect, Gameover_Rect, Restart_Rect, crouch, TheDINO_Rect, Hit_Surface);
+            renderer.RenderGameover(Hit_Rect, Gameover_Rect, Restart_Rect, game_state);
 
             while (SDL_WaitEvent(&MainEvent))
             {
@@ -415,8 +578,7 @@ void DinoGame::Play() {
                 switch (MainEvent.type)
                 {
                     case SDL_QUIT:
-                        stop_thread = true;
-                        t.join();
+                        EndSession(t);
                         return;
                         break;
 
@@ -424,8 +586,7 @@ void DinoGame::Play() {
                         switch (MainEvent.key.keysym.sym)
                         {
                             case SDLK_ESCAPE:
-                                stop_thread = true;
-                                t.join();
+                                EndSession(t);
                                 return;
                                 break;
 
@@ -457,29 +618,26 @@ void DinoGame::Play() {
                 {
                     Mix_ResumeMusic();
 
-                    if (score_m / 5 > highestscore)
+                    if (game_state.score_m / 5 > highestscore)
                     {
-                        highestscore = score_m / 5;
+                        highestscore = game_state.score_m / 5;
                     }
 
-                    SDL_FreeSurface(HI_Surface);
-                    SDL_DestroyTexture(HI_Texture);
                     Set();
 
                     break;
                 }
             }
             SDL_Delay(100);
-        }
-        else
-        {
-            ControlFPS(FStartTime);
+            // 结束画面停留的时间不计入节拍
+            previous_state = game_state;
+            pacer.Start();
         }
 
         if ( pause) //暂停
         {
             // 调用新的 RenderGameover 函数
-            renderer.RenderPause(Hit_Texture,  Hit_Rect, crouch, TheDINO_Rect, Hit_Surface);
+            renderer.RenderPause(Hit_Rect, game_state);
 
             while (SDL_WaitEvent(&MainEvent))
             {
@@ -487,8 +645,7 @@ void DinoGame::Play() {
                 switch (MainEvent.type)
                 {
                     case SDL_QUIT:
-                        stop_thread = true;
-                        t.join();
+                        EndSession(t);
                         return;
                         break;
 
@@ -496,6 +653,7 @@ void DinoGame::Play() {
                         switch (MainEvent.key.keysym.sym)
                         {
                             case SDLK_ESCAPE:
+                                EndSession(t);
                                 return;
                                 break;
 
@@ -521,44 +679,131 @@ void DinoGame::Play() {
                     pause = false;
                     Mix_ResumeMusic();
 
-                    if (score_m / 5 > highestscore)
+                    if (game_state.score_m / 5 > highestscore)
                     {
-                        highestscore = score_m / 5;
+                        highestscore = game_state.score_m / 5;
                     }
 
-//                    SDL_FreeSurface(HI_Surface);
-//                    SDL_DestroyTexture(HI_Texture);
 //                    Set();
 
                     break;
                 }
             }
             SDL_Delay(100);
+            previous_state = game_state;
+            pacer.Start();
         }
-        else
-        {
-            ControlFPS(FStartTime);
+
+        pacer.Wait();
+    }
+
+    EndSession(t);
+}
+
+bool DinoGame::DrainDecoderEvents(int slot, GameInput& input) {
+    const uint64_t newest = acq_frame.load(std::memory_order_acquire);
+    const uint64_t consume_ns = MonotonicNs();
+    // 只有第 0 路显示在窗口中，到画面呈现的延迟只统计它的事件
+    if (slot == 0) {
+        tick_consume_ns = consume_ns;
+    }
+    uint64_t batch = 0;
+    bool jump = false;
+    DecoderEvent ev;
+    while (well_links[slot].decoder_events.Pop(ev)) {
+        ++batch;
+        latency.Record(Stage_Push_Consume, ev.push_ns, consume_ns);
+        if (slot == 0) {
+            tick_recv_ns.push_back(ev.recv_ns);
+        }
+        if (ev.action == DecoderAction::Jump) {
+            input.jump = true;
+            jump = true;
+            ++jumps_decoded;
+            Bump(metrics.Data().game.jumps_consumed);
+        }
+        // 消费者滞后：事件帧号与采集线程当前帧号之差
+        if (newest > ev.frame && newest - ev.frame > max_lag_frames) {
+            max_lag_frames = newest - ev.frame;
         }
     }
+    events_drained += batch;
+    if (batch > max_batch) {
+        max_batch = batch;
+    }
+    return jump;
+}
+
+// 一局的结束记录：tick 数和状态校验和，回放时逐位比较
+void DinoGame::RecordGameEnd(const WellGame& game) {
+    const uint64_t frame = acq_frame.load(std::memory_order_relaxed);
+    recorder.AppendEvent(Lane_Game, Event_End, frame, static_cast<int64_t>(game.tick_no), game.well);
+    recorder.AppendEvent(Lane_Game, Event_Checksum, frame, static_cast<int64_t>(GameChecksum(*game.state)), game.well);
+}
+
+// 序列号到序列名的对应写入会话记录，离线分析不依赖当时的策略文件
+void DinoGame::RecordSequenceNames() {
+    const StimPolicy& policy = *stim_policies.Current();
+    const uint64_t frame = acq_frame.load(std::memory_order_relaxed);
+    for (int sequence = 1; sequence <= policy.SequenceCount() && sequence <= 0xFF; ++sequence) {
+        const std::string name = policy.SequenceName(sequence);
+        for (size_t part = 0; part == 0 || part * kSequenceNamePart < name.size(); ++part) {
+            recorder.AppendEvent(Lane_Game, Event_SequenceName, frame, PackSequenceName(sequence, part, name));
+        }
+    }
+}
 
-    t.join();
+void DinoGame::RecordPresentLatency() {
+    if (tick_recv_ns.empty()) {
+        return;
+    }
+    const uint64_t present_ns = MonotonicNs();
+    latency.Record(Stage_Consume_Present, tick_consume_ns, present_ns);
+    for (uint64_t recv_ns : tick_recv_ns) {
+        latency.Record(Stage_Recv_Present, recv_ns, present_ns);
+    }
+    tick_recv_ns.clear();
 }
 
-void DinoGame::ControlFPS(clock_t FStartTime) {
-    FDurTime = clock() - FStartTime;
-    if (FDurTime <= 1000 / mFPS / rate) {
-        SDL_Delay(1000 / mFPS / rate - FDurTime);
+void DinoGame::EndSession(std::thread& thread) {
+    stop_thread = true;
+    if (thread.joinable()) {
+        thread.join();
+    }
+    metrics.Close();
+    TraceStop();
+    if (recorder.Enabled()) {
+        // 局中退出（含暂停画面）时补记本局结束；结束画面中退出时已经记过
+        for (const WellGame& game : wells) {
+            if (game.state->life >= 0) {
+                RecordGameEnd(game);
+            }
+        }
+        recorder.Stop();
+        recorder.Print(stdout);
+    }
+    printf("trace records dropped: %lu\n", TraceDropped());
+    uint64_t dropped = 0;
+    for (const WellGame& game : wells) {
+        dropped += well_links[game.slot].decoder_events.Dropped();
+    }
+    printf("decoder events: drained=%lu jumps=%lu dropped=%lu max_batch=%lu max_lag=%lu frames\n",
+           events_drained, jumps_decoded, dropped, max_batch, max_lag_frames);
+    if (wells.size() > 1) {
+        for (const WellGame& game : wells) {
+            printf("well %u: games=%lu best_score=%lu\n", game.well, game.games_started, game.best_score);
+        }
     }
+    latency.Dump(stdout);
+    pacer.Print(stdout);
 }
 
-void DinoGame::CD() {
-    for (int i = 0; i < 3; ++i) {
-        if (SDL_HasIntersection(&TheDINO_Rect[0], &Obstacle_Use[i].Rect[0])) {
-            collision = true;
-            std::cout << "collision" << collision << std::endl;
-            life--;
-            return;
+void DinoGame::CD(WellGame& game) {
+    if (GameCollide(*game.state)) {
+        if (game.slot == 0) {
+            std::cout << "collision" << game.state->collision << std::endl;
         }
+        recorder.AppendEvent(Lane_Game, Event_Collision, acq_frame.load(std::memory_order_relaxed), game.state->life, game.well);
     }
 }
 
@@ -3,6 +3,8 @@
 
 #include "Globals.h"
 #include "Renderer.h"
+#include "FramePacer.h"
+#include "AssetPack.h"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
@@ -10,8 +12,23 @@
 #include <atomic>
 #include <ctime>
 #include <thread>
+#include <vector>
+#include <climits>
 
 
+// 一个井对应的一局游戏。第 0 路就是全局 game_state，显示在窗口中并接收键盘；
+// 多井（DINO_WELLS）时其余各路在后台与第 0 路同 tick 推进，一局结束后自动开下一局
+struct WellGame {
+    int slot = 0;
+    uint8_t well = 0;               // 井号，写入会话记录
+    GameState* state = nullptr;
+    uint64_t games_started = 0;     // 第 n 局的种子为 session_seed + n，各井的障碍物序列相同
+    uint64_t tick_no = 0;           // 本局已推进的 tick 数
+    TickClock clock;                // 后台井按自己的 rate 计 tick；第 0 路由 DinoGame::pacer 计
+    int last_distance = INT_MAX;
+    unsigned long best_score = 0;
+};
+
 class DinoGame {
 public:
     DinoGame();
@@ -22,13 +39,39 @@ public:
     void Jump();
     void Play();
     void Set();
-    void ControlFPS(clock_t FStartTime);
-    void CD();
+    void StartGame(WellGame& game);
+    void TickWell(WellGame& game, GameInput& input);
+    void FinishGame(WellGame& game);                // 多井时一局结束：记录并开下一局
+    void CD(WellGame& game);
     void QUIT();
+    bool DrainDecoderEvents(int slot, GameInput& input);    // 返回本 tick 是否有解码跳跃
+    void RecordPresentLatency();
+    void EndSession(std::thread& thread);
+    void RecordGameEnd(const WellGame& game);
+    void RecordSequenceNames();                     // 加载刺激策略后写出序列名
 
     SDL_Event MainEvent;
 
     Renderer renderer; // 渲染器对象
+    AssetPack assets;  // 资源包映射，图集建好后关闭
+    SDL_Surface* sprites[SpriteCount] = {};    // Load 得到、PrepareAll 交给图集
+    FramePacer pacer = FramePacerFromEnv();   // 游戏循环节拍
+
+    // 解码事件队列统计
+    uint64_t events_drained = 0;
+    uint64_t jumps_decoded = 0;
+    uint64_t max_batch = 0;        // 单个 tick 取出的最多事件数
+    uint64_t max_lag_frames = 0;   // 消费者最大滞后帧数
+
+    // 上次画面之后第 0 路取出的事件，画面呈现后计算延迟
+    std::vector<uint64_t> tick_recv_ns;
+    uint64_t tick_consume_ns = 0;
+
+    // 回放记录：每局种子 = session_seed + 局序号
+    uint64_t session_seed = SessionSeed();
+
+    std::vector<GameState> background_states;   // 第 1 路起的游戏状态
+    std::vector<WellGame> wells;                // 按 well_layout 的路编号
     
 };
 
@@ -0,0 +1,76 @@
+#include "FrameMonitor.h"
+#include "Latency.h"
+#include <cstdlib>
+
+FrameMonitor::FrameMonitor(uint32_t deadline_us)
+    : deadline_frames_(static_cast<uint64_t>(deadline_us) * kSampleRate / 1000000) {}
+
+void FrameMonitor::Anchor() {
+    anchor_ns_ = MonotonicNs();
+    anchor_frame_ = last_frame_;
+    received_since_anchor_ = false;
+    backlog_ = 0;
+}
+
+uint64_t FrameMonitor::Received(uint64_t frame_no, uint64_t recv_ns, bool corrupted) {
+    ++frames_;
+    if (corrupted) {
+        ++corrupted_;
+    }
+    uint64_t missing = 0;
+    if (!started_) {
+        started_ = true;
+        last_frame_ = frame_no;
+        anchor_ns_ = recv_ns;
+        anchor_frame_ = frame_no;
+    } else if (frame_no > last_frame_) {
+        missing = frame_no - last_frame_ - 1;
+        last_frame_ = frame_no;
+    } else {
+        ++reordered_;
+    }
+    if (missing > 0) {
+        ++gaps_;
+        missing_frames_ += missing;
+        if (missing > max_gap_) {
+            max_gap_ = missing;
+        }
+    }
+
+    ++backlog_;
+    if (backlog_ > max_backlog_) {
+        max_backlog_ = backlog_;
+    }
+    received_since_anchor_ = true;
+
+    // 自追上以来按实时应到达的帧号
+    const uint64_t elapsed_frames = recv_ns > anchor_ns_ ? (recv_ns - anchor_ns_) * kSampleRate / 1000000000 : 0;
+    const uint64_t expected = anchor_frame_ + elapsed_frames;
+    lag_frames_ = expected > frame_no ? expected - frame_no : 0;
+    if (lag_frames_ > max_lag_frames_) {
+        max_lag_frames_ = lag_frames_;
+    }
+    if (lag_frames_ > deadline_frames_) {
+        ++late_frames_;
+        if (!late_) {
+            late_ = true;
+            ++deadline_misses_;
+        }
+    } else {
+        late_ = false;
+    }
+    return missing;
+}
+
+void FrameMonitor::Print(FILE* out, const char* name) const {
+    fprintf(out, "%s: frames=%lu gaps=%lu missing=%lu max_gap=%lu corrupted=%lu reordered=%lu max_backlog=%lu\n", name,
+            frames_, gaps_, missing_frames_, max_gap_, corrupted_, reordered_, max_backlog_);
+    fprintf(out, "%s deadline %.2f ms: late_frames=%lu misses=%lu max_lag=%.2f ms\n", name,
+            deadline_frames_ * 1000.0 / kSampleRate, late_frames_, deadline_misses_, max_lag_frames_ * 1000.0 / kSampleRate);
+}
+
+uint32_t FrameDeadlineUsFromEnv() {
+    const char* v = getenv("DINO_FRAME_DEADLINE_US");
+    const long us = v ? strtol(v, nullptr, 10) : 0;
+    return us > 0 ? static_cast<uint32_t>(us) : 1000;
+}
@@ -0,0 +1,70 @@
+#ifndef FRAME_MONITOR_H
+#define FRAME_MONITOR_H
+
+#include <cstdint>
+#include <cstdio>
+
+// 数据流健康监测：帧号缺口、损坏帧、积压和实时期限。解码器和刺激间隔都假定每一帧都被看到，这里把例外计数出来。
+// 滞后以"追上"为基准：一次 MAXLAB_NO_FRAME 说明流中已没有待取的帧，记下当时的时刻和帧号；
+// 之后每收到一帧，按 20 kHz 推算此刻本应到达的帧号，与正在处理的帧号之差即为滞后。以追上时刻为锚点，不受两边时钟漂移影响
+class FrameMonitor {
+public:
+    static constexpr uint64_t kSampleRate = 20000;
+
+    explicit FrameMonitor(uint32_t deadline_us);
+
+    // 一次空轮询；只在上次空轮询之后收到过帧时取时钟
+    void Empty() {
+        if (received_since_anchor_) {
+            Anchor();
+        }
+    }
+
+    // 收到一帧，返回与上一帧之间缺失的帧数
+    uint64_t Received(uint64_t frame_no, uint64_t recv_ns, bool corrupted);
+
+    uint64_t Frames() const { return frames_; }
+    uint64_t Gaps() const { return gaps_; }
+    uint64_t MissingFrames() const { return missing_frames_; }
+    uint64_t MaxGap() const { return max_gap_; }
+    uint64_t Corrupted() const { return corrupted_; }
+    uint64_t Reordered() const { return reordered_; }
+    uint64_t Backlog() const { return backlog_; }           // 当前连续取到的帧数（中间没有空轮询）
+    uint64_t MaxBacklog() const { return max_backlog_; }
+    uint64_t LagFrames() const { return lag_frames_; }      // 最近一帧处理时落后实时的帧数
+    uint64_t MaxLagFrames() const { return max_lag_frames_; }
+    uint64_t LateFrames() const { return late_frames_; }    // 处理时已超过期限的帧
+    uint64_t DeadlineMisses() const { return deadline_misses_; }    // 从按时转为超期的次数
+
+    void Print(FILE* out, const char* name) const;
+
+private:
+    void Anchor();
+
+    uint64_t deadline_frames_;
+
+    bool started_ = false;
+    bool received_since_anchor_ = false;
+    bool late_ = false;
+    uint64_t last_frame_ = 0;
+    uint64_t anchor_ns_ = 0;
+    uint64_t anchor_frame_ = 0;
+
+    uint64_t frames_ = 0;
+    uint64_t gaps_ = 0;
+    uint64_t missing_frames_ = 0;
+    uint64_t max_gap_ = 0;
+    uint64_t corrupted_ = 0;
+    uint64_t reordered_ = 0;    // 帧号不增反退
+    uint64_t backlog_ = 0;
+    uint64_t max_backlog_ = 0;
+    uint64_t lag_frames_ = 0;
+    uint64_t max_lag_frames_ = 0;
+    uint64_t late_frames_ = 0;
+    uint64_t deadline_misses_ = 0;
+};
+
+// DINO_FRAME_DEADLINE_US：一帧到达后须在多少微秒内处理完，默认 1000
+uint32_t FrameDeadlineUsFromEnv();
+
+#endif
@@ -0,0 +1,121 @@
+#include "FramePacer.h"
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include "GameState.h"
+
+FramePacer::FramePacer(double render_fps, uint32_t spin_us)
+    : render_period_ns_(render_fps > 0 ? static_cast<uint64_t>(1e9 / render_fps) : 0),
+      spin_ns_(spin_us * 1000ull) {
+    Start();
+}
+
+void FramePacer::Start() {
+    last_ns_ = MonotonicNs();
+    elapsed_ns_ = 0;
+    accumulator_ns_ = 0;
+    next_render_ns_ = last_ns_;
+    last_tick_ns_ = 0;
+}
+
+int FramePacer::Advance(double rate) {
+    period_ns_ = static_cast<uint64_t>(1e9 / (mFPS * rate));
+
+    const uint64_t now = MonotonicNs();
+    elapsed_ns_ = now - last_ns_;
+    accumulator_ns_ += elapsed_ns_;
+    active_ns_ += elapsed_ns_;
+    last_ns_ = now;
+
+    int ticks = 0;
+    while (accumulator_ns_ >= period_ns_) {
+        if (ticks == kMaxCatchUp) {
+            dropped_ticks_ += accumulator_ns_ / period_ns_;
+            accumulator_ns_ %= period_ns_;
+            break;
+        }
+        lateness_.Record(accumulator_ns_ - period_ns_);
+        accumulator_ns_ -= period_ns_;
+        ++ticks;
+    }
+    if (ticks > 1) {
+        ++overruns_;
+    }
+    if (ticks > 0) {
+        if (last_tick_ns_ != 0) {
+            interval_.Record(now - last_tick_ns_);
+        }
+        last_tick_ns_ = now;
+        ticks_ += ticks;
+    }
+    return ticks;
+}
+
+bool FramePacer::RenderDue() {
+    bool due;
+    if (render_period_ns_ == 0) {
+        due = last_tick_ns_ == last_ns_;
+    } else {
+        due = last_ns_ >= next_render_ns_;
+        if (due) {
+            // 落后超过一帧时不补画，从现在重新对齐
+            next_render_ns_ += render_period_ns_;
+            if (next_render_ns_ < last_ns_) {
+                next_render_ns_ = last_ns_ + render_period_ns_;
+            }
+        }
+    }
+    renders_ += due;
+    return due;
+}
+
+double FramePacer::Alpha() const {
+    if (render_period_ns_ == 0 || period_ns_ == 0) {
+        return 1.0;
+    }
+    return static_cast<double>(accumulator_ns_) / period_ns_;
+}
+
+void FramePacer::Wait() const {
+    uint64_t deadline = last_ns_ + (period_ns_ > accumulator_ns_ ? period_ns_ - accumulator_ns_ : 0);
+    if (render_period_ns_ != 0 && next_render_ns_ < deadline) {
+        deadline = next_render_ns_;
+    }
+    uint64_t now = MonotonicNs();
+    if (deadline > now + spin_ns_) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(deadline - now - spin_ns_));
+    }
+    // 睡眠唤醒误差在几十微秒量级，最后一段自旋对齐
+    while (MonotonicNs() < deadline) {
+    }
+}
+
+void FramePacer::Print(FILE* out) const {
+    const double seconds = active_ns_ / 1e9;
+    fprintf(out, "frame pacing: ticks=%lu renders=%lu target=%.1f Hz achieved=%.2f Hz overruns=%lu dropped_ticks=%lu\n",
+            ticks_, renders_, period_ns_ ? 1e9 / period_ns_ : 0.0, seconds > 0 ? ticks_ / seconds : 0.0,
+            overruns_, dropped_ticks_);
+    lateness_.Print(out, "tick lateness");
+    interval_.Print(out, "tick interval");
+}
+
+int TickClock::Advance(uint64_t elapsed_ns, double rate) {
+    const uint64_t period_ns = static_cast<uint64_t>(1e9 / (mFPS * rate));
+    accumulator_ns_ += elapsed_ns;
+    int ticks = 0;
+    while (accumulator_ns_ >= period_ns) {
+        if (ticks == FramePacer::kMaxCatchUp) {
+            accumulator_ns_ %= period_ns;
+            break;
+        }
+        accumulator_ns_ -= period_ns;
+        ++ticks;
+    }
+    return ticks;
+}
+
+FramePacer FramePacerFromEnv() {
+    const char* fps = getenv("DINO_RENDER_FPS");
+    const char* spin = getenv("DINO_PACE_SPIN_US");
+    return FramePacer(fps ? atof(fps) : 0.0, spin ? strtoul(spin, nullptr, 10) : 200);
+}
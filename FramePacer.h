@@ -0,0 +1,62 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <cstdint>
+#include <cstdio>
+#include "Latency.h"
+
+// 固定步长的游戏循环节拍：墙钟时间累加进累加器，每满一个周期推进一个 tick。
+// tick 频率 = mFPS × rate（与原 ControlFPS 相同，rate 随分数加速），与进程 CPU 占用无关。
+// render_fps 为 0 时每个 tick 画一帧且不插值；否则按 render_fps 画面，在两次 tick 之间插值
+class FramePacer {
+public:
+    static constexpr int kMaxCatchUp = 5;   // 单次最多补几个 tick，再落后的时间直接丢弃
+
+    FramePacer(double render_fps, uint32_t spin_us);
+
+    void Start();                   // 开局或暂停/结束画面返回后调用，清空累加器
+    int Advance(double rate);       // 返回本次需要推进的 tick 数
+    bool RenderDue();               // 本次循环是否画面
+    double Alpha() const;           // 渲染插值系数，0 = 上一个 tick，1 = 当前 tick
+    void Wait() const;              // 睡到下一个 tick 或下一帧画面，最后 spin_us 自旋
+
+    void Print(FILE* out) const;
+
+    uint64_t ElapsedNs() const { return elapsed_ns_; }     // 上次 Advance 计入的墙钟时间
+    uint64_t Overruns() const { return overruns_; }
+    uint64_t DroppedTicks() const { return dropped_ticks_; }
+
+private:
+    uint64_t period_ns_ = 0;
+    uint64_t render_period_ns_ = 0;
+    uint64_t spin_ns_ = 0;
+    uint64_t last_ns_ = 0;
+    uint64_t elapsed_ns_ = 0;
+    uint64_t accumulator_ns_ = 0;
+    uint64_t next_render_ns_ = 0;
+    uint64_t last_tick_ns_ = 0;
+
+    uint64_t ticks_ = 0;
+    uint64_t renders_ = 0;
+    uint64_t overruns_ = 0;         // 一次循环需要补多个 tick 的次数
+    uint64_t dropped_ticks_ = 0;    // 超过 kMaxCatchUp 被丢弃的 tick
+    uint64_t active_ns_ = 0;        // 游戏实际运行的时间（不含暂停与结束画面）
+    LatencyHistogram lateness_;     // tick 实际执行时刻 - 应执行时刻
+    LatencyHistogram interval_;     // 相邻两个 tick 的间隔
+};
+
+// 不画面的后台游戏的节拍：墙钟时间取自 FramePacer::ElapsedNs，tick 频率按该局自己的 rate，
+// 多井时各井的速度只取决于各自的分数
+class TickClock {
+public:
+    void Start() { accumulator_ns_ = 0; }
+    int Advance(uint64_t elapsed_ns, double rate);  // 返回本次需要推进的 tick 数，最多 FramePacer::kMaxCatchUp
+
+private:
+    uint64_t accumulator_ns_ = 0;
+};
+
+// DINO_RENDER_FPS（默认 0，与 tick 同步）、DINO_PACE_SPIN_US（默认 200）
+FramePacer FramePacerFromEnv();
+
+#endif
@@ -0,0 +1,372 @@
+#include "GameState.h"
+#include <climits>
+#include <cstddef>
+
+// 无贴图时使用的尺寸，与 images/ 中的素材大致相同
+GameGeometry DefaultGeometry() {
+    GameGeometry geo{};
+    geo.dino_menu = {50, Height_Window - 120, 88, 94};
+    geo.dino[0] = {geo.dino_menu.x + 4, geo.dino_menu.y, 80, 86};
+    geo.dino[1] = {geo.dino_menu.x + 4, geo.dino_menu.y + 34, 110, 52};
+    geo.road = {0, geo.dino_menu.y + geo.dino_menu.h - 24, 2400, 24};
+    geo.cloud = {0, 0, 92, 27};
+
+    const int obstacle_size[7][2] = {{34, 70}, {68, 70}, {102, 70}, {50, 100}, {100, 100}, {150, 100}, {75, 100}};
+    for (int i = 0; i < 7; ++i) {
+        geo.obstacles[i] = {0, geo.road.y - obstacle_size[i][1] + 22, obstacle_size[i][0], obstacle_size[i][1]};
+    }
+    for (int i = 0; i < 2; ++i) {
+        geo.birds[i] = {0, geo.road.y - 120, 92, 80};
+    }
+    geo.min_interval_half = MinInterval_Half;
+    geo.spawn_spacing = Width_Window / 2;
+    geo.bird_percent = 0;
+    return geo;
+}
+
+void GameReset(GameState& state, const GameGeometry& geo) {
+    state.jump = false;
+    state.down = false;
+    state.crouch = false;
+    state.collision = false;
+    state.j = 0;
+    state.life = 4;
+    state.rate = 1.0;
+    state.score_m = 0;
+    state.r = 4111;
+
+    state.dino[0] = geo.dino[0];
+    state.dino[1] = geo.dino[1];
+    state.std_ = geo.dino_menu.y;
+
+    // 设置跑道
+    state.road[0] = {0, geo.road.y, geo.road.w, geo.road.h};
+    state.road[1] = {geo.road.w, geo.road.y, geo.road.w, geo.road.h};
+
+    // 云的矩形区域
+    state.cloud[0] = {static_cast<int>(0.11 * Width_Window), static_cast<int>(0.29 * Height_Window), geo.cloud.w, geo.cloud.h};
+    state.cloud[1] = {static_cast<int>(0.36 * Width_Window), static_cast<int>(0.23 * Height_Window), geo.cloud.w, geo.cloud.h};
+    state.cloud[2] = {static_cast<int>(0.61 * Width_Window), static_cast<int>(0.37 * Height_Window), geo.cloud.w, geo.cloud.h};
+    state.cloud[3] = {static_cast<int>(0.89 * Width_Window), static_cast<int>(0.21 * Height_Window), geo.cloud.w, geo.cloud.h};
+
+    // 第一个 tick 就生成第一个障碍物
+    ObstaclePool& pool = state.obstacles;
+    pool.count = 0;
+    pool.ahead = 0;
+    pool.front = geo.dino[0].x + geo.dino[0].w;
+    pool.countdown = 0;
+    pool.next_serial = 0;
+
+    state.pose = DinoPose::Running;
+    state.pose_frame = 0;
+}
+
+void GameSeed(GameState& state, uint64_t seed) {
+    state.rng = seed;
+}
+
+// SplitMix64：状态只有一个 64 位整数，复制 GameState 即可复制随机序列
+static uint32_t GameRandom(GameState& state) {
+    uint64_t z = (state.rng += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return static_cast<uint32_t>((z ^ (z >> 31)) >> 32);
+}
+
+static void StepBackground(GameState& state, const GameGeometry& geo) {
+    for (int i = 0; i < 2; i++)
+    {
+        state.road[i].x -= V;
+        if (state.road[i].x < -geo.road.w)
+        {
+            state.road[i].x += geo.road.w * 2;
+        }
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        state.cloud[i].x -= V / 4;
+        if (state.cloud[i].x < -geo.cloud.w)
+        {
+            state.cloud[i].x = Width_Window;
+        }
+    }
+}
+
+// 在下一个生成窗口 [Width_Window + interval, Width_Window + spawn_spacing - interval) 内随机放一个障碍物
+static void SpawnObstacle(GameState& state, const GameGeometry& geo) {
+    ObstaclePool& pool = state.obstacles;
+    if (pool.count == kMaxObstacles) {
+        return;
+    }
+    const bool bird = geo.bird_percent > 0 && static_cast<int>(GameRandom(state) % 100) < geo.bird_percent;
+    const int kind = bird ? kBirdKind : static_cast<int>(GameRandom(state) % kObstacleKinds);
+    const GameRect& shape = bird ? geo.birds[0] : geo.obstacles[kind];
+    const int interval = geo.min_interval_half;
+    int x = Width_Window + interval + static_cast<int>(GameRandom(state) % (geo.spawn_spacing - interval * 2 - shape.w));
+    // 两次生成之间实际前进的距离可能比 spawn_spacing 少不到一个 V，interval 为 0 时靠这里保持有序
+    if (pool.count > 0 && x <= pool.x[pool.count - 1]) {
+        x = pool.x[pool.count - 1] + 1;
+    }
+
+    const int i = pool.count++;
+    pool.kind[i] = static_cast<int8_t>(kind);
+    pool.serial[i] = pool.next_serial++;
+    pool.x[i] = x;
+    pool.y[i] = shape.y;
+    pool.w[i] = shape.w;
+    pool.h[i] = shape.h;
+}
+
+static void StepObstacles(GameState& state, const GameGeometry& geo) {
+    ObstaclePool& pool = state.obstacles;
+
+    pool.countdown -= V;
+    if (pool.countdown <= 0) {
+        pool.countdown += geo.spawn_spacing;
+        SpawnObstacle(state, geo);
+    }
+
+    for (int i = 0; i < pool.count; ++i) {
+        pool.x[i] -= V;
+    }
+
+    // 完全移出屏幕左侧的从头部删除
+    int gone = 0;
+    while (gone < pool.count && pool.x[gone] + pool.w[gone] <= 0) {
+        ++gone;
+    }
+    if (gone > 0) {
+        const int keep = pool.count - gone;
+        for (int i = 0; i < keep; ++i) {
+            pool.kind[i] = pool.kind[i + gone];
+            pool.serial[i] = pool.serial[i + gone];
+            pool.x[i] = pool.x[i + gone];
+            pool.y[i] = pool.y[i + gone];
+            pool.w[i] = pool.w[i + gone];
+            pool.h[i] = pool.h[i + gone];
+        }
+        pool.count = keep;
+        pool.ahead -= gone;     // 被删除的都在恐龙身后，ahead 不小于 gone
+    }
+
+    while (pool.ahead < pool.count && pool.x[pool.ahead] - pool.front <= 0) {
+        ++pool.ahead;
+    }
+}
+
+// 跳跃轨迹上第 j 步的位移
+static double JumpDelta(int j) {
+    return (j - V * Tan) * 2 * Height_Window / (double)(3 * V * Tan * V * Tan);
+}
+
+static void StepDino(GameState& state, const GameGeometry& geo) {
+    if (state.down)
+    {
+        if (state.jump && state.dino[0].y != geo.dino_menu.y)//Rapidly Drop
+        {
+            state.j = state.j <= V * Tan ? 2 * V * Tan + 1 - state.j : state.j;
+            for (int i = 0; i < 3 && state.jump; i++)
+            {
+                state.std_ += JumpDelta(state.j);
+                state.dino[0].y = state.std_;
+                state.j++;
+                if (state.j == 2 * V * Tan + 1)
+                {
+                    state.j = 0;
+                    state.dino[0].y = geo.dino_menu.y;//Reset dino[0].y(bug来自于std取整)
+                    state.jump = false;
+                }
+            }
+            state.pose = DinoPose::Jumping;
+        }
+        else//Crouch
+        {
+            state.pose = DinoPose::Crouching;
+            state.pose_frame = state.r % 2;
+            state.r >>= 1;
+            if (state.r == 16)
+            {
+                state.r = 4111;
+            }
+            state.jump = false;
+            state.crouch = true;
+        }
+    }
+    else if (state.jump)
+    {
+        state.std_ += JumpDelta(state.j);
+        state.dino[0].y = state.std_;
+        state.j++;
+        state.pose = DinoPose::Jumping;
+        if (state.j == 2 * V * Tan + 1)
+        {
+            state.j = 0;
+            state.dino[0].y = geo.dino_menu.y;//Reset dino[0].y(bug来自于std取整)
+            state.jump = false;
+        }
+    }
+    else//Running
+    {
+        state.pose = DinoPose::Running;
+        state.pose_frame = state.r % 2;
+        state.r >>= 1;
+        if (state.r == 16)
+        {
+            state.r = 4111;
+        }
+    }
+}
+
+void GameStep(GameState& state, const GameGeometry& geo, const GameInput& input) {
+    if (input.jump) {
+        state.jump = true;
+    }
+    if (state.down && !input.down) {
+        state.crouch = false;
+    }
+    state.down = input.down;
+
+    state.score_m++;
+    //Select Speed
+    if (state.score_m >= 2500)
+    {
+        state.rate = 1.25;
+    }
+    else if (state.score_m >= 10000)
+    {
+        state.rate = 1.5;
+    }
+
+    StepBackground(state, geo);
+    StepObstacles(state, geo);
+    StepDino(state, geo);
+}
+
+bool GameCollide(GameState& state) {
+    const GameRect& body = state.crouch ? state.dino[1] : state.dino[0];
+    const ObstaclePool& pool = state.obstacles;
+    // 按 x 升序，左边缘越过恐龙右侧之后的都不可能相交
+    for (int i = 0; i < pool.count && pool.x[i] < body.x + body.w; ++i) {
+        if (HasIntersection(body, pool.Rect(i))) {
+            state.collision = true;
+            state.life--;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int Lerp(int from, int to, double alpha) {
+    const int delta = to - from;
+    if (delta > V * 4 || delta < -V * 4) {
+        return to;
+    }
+    return from + static_cast<int>(delta * alpha);
+}
+
+GameState GameInterpolate(const GameState& previous, const GameState& current, double alpha) {
+    if (alpha >= 1.0) {
+        return current;
+    }
+    GameState state = current;
+    state.dino[0].y = previous.dino[0].y + static_cast<int>((current.dino[0].y - previous.dino[0].y) * alpha);
+    for (int i = 0; i < 2; ++i) {
+        state.road[i].x = Lerp(previous.road[i].x, current.road[i].x, alpha);
+    }
+    for (int i = 0; i < 4; ++i) {
+        state.cloud[i].x = Lerp(previous.cloud[i].x, current.cloud[i].x, alpha);
+    }
+    // 两个池都按生成序号递增，双指针找同一个障碍物；新生成的直接取当前位置
+    const ObstaclePool& before = previous.obstacles;
+    ObstaclePool& after = state.obstacles;
+    for (int i = 0, k = 0; i < after.count; ++i) {
+        while (k < before.count && before.serial[k] < after.serial[i]) {
+            ++k;
+        }
+        if (k < before.count && before.serial[k] == after.serial[i]) {
+            after.x[i] = Lerp(before.x[k], after.x[i], alpha);
+        }
+    }
+    return state;
+}
+
+static void Mix(uint64_t& hash, const void* data, size_t bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+        hash = (hash ^ p[i]) * 0x100000001B3ull;
+    }
+}
+
+uint64_t GameChecksum(const GameState& state) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    const bool flags[4] = {state.jump, state.down, state.crouch, state.collision};
+    Mix(hash, flags, sizeof(flags));
+    Mix(hash, &state.j, sizeof(state.j));
+    Mix(hash, &state.life, sizeof(state.life));
+    Mix(hash, &state.score_m, sizeof(state.score_m));
+    Mix(hash, &state.r, sizeof(state.r));
+    Mix(hash, &state.rate, sizeof(state.rate));
+    Mix(hash, &state.std_, sizeof(state.std_));
+    Mix(hash, &state.rng, sizeof(state.rng));
+    Mix(hash, state.dino, sizeof(state.dino));
+    Mix(hash, state.road, sizeof(state.road));
+    Mix(hash, state.cloud, sizeof(state.cloud));
+    const ObstaclePool& pool = state.obstacles;
+    const int header[4] = {pool.count, pool.ahead, pool.front, pool.countdown};
+    Mix(hash, header, sizeof(header));
+    Mix(hash, &pool.next_serial, sizeof(pool.next_serial));
+    Mix(hash, pool.kind, pool.count * sizeof(pool.kind[0]));
+    Mix(hash, pool.serial, pool.count * sizeof(pool.serial[0]));
+    Mix(hash, pool.x, pool.count * sizeof(pool.x[0]));
+    Mix(hash, pool.y, pool.count * sizeof(pool.y[0]));
+    Mix(hash, pool.w, pool.count * sizeof(pool.w[0]));
+    Mix(hash, pool.h, pool.count * sizeof(pool.h[0]));
+    const int pose[2] = {static_cast<int>(state.pose), state.pose_frame};
+    Mix(hash, pose, sizeof(pose));
+    return hash;
+}
+
+int MaxMinIntervalHalf(const GameGeometry& geo) {
+    int widest = geo.birds[0].w;
+    for (int i = 0; i < kObstacleKinds; ++i) {
+        if (geo.obstacles[i].w > widest) {
+            widest = geo.obstacles[i].w;
+        }
+    }
+    return (geo.spawn_spacing - widest - 1) / 2;
+}
+
+static int* RectField(GameRect& rect, int index) {
+    int* const fields[4] = {&rect.x, &rect.y, &rect.w, &rect.h};
+    return fields[index];
+}
+
+// 编号顺序与早期按内存逐项写出的记录一致，旧记录仍可回放
+int* GeometryField(GameGeometry& geo, int index) {
+    if (index < 0 || index >= kGeometryFields) {
+        return nullptr;
+    }
+    GameRect* const rects[] = {
+        &geo.dino_menu, &geo.dino[0], &geo.dino[1], &geo.road, &geo.cloud,
+        &geo.obstacles[0], &geo.obstacles[1], &geo.obstacles[2], &geo.obstacles[3],
+        &geo.obstacles[4], &geo.obstacles[5], &geo.obstacles[6],
+        &geo.birds[0], &geo.birds[1],
+    };
+    constexpr int kRects = sizeof(rects) / sizeof(rects[0]);
+    static_assert(kObstacleKinds == 7, "GeometryField lists each obstacle");
+    static_assert(kGeometryFields == 4 * kRects + 3, "kGeometryFields does not match GeometryField");
+    if (index < 4 * kRects) {
+        return RectField(*rects[index / 4], index % 4);
+    }
+    int* const tail[3] = {&geo.min_interval_half, &geo.spawn_spacing, &geo.bird_percent};
+    return tail[index - 4 * kRects];
+}
+
+// 与 SDL_HasIntersection 一致：空矩形不相交
+bool HasIntersection(const GameRect& a, const GameRect& b) {
+    if (a.w <= 0 || a.h <= 0 || b.w <= 0 || b.h <= 0) {
+        return false;
+    }
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
@@ -0,0 +1,121 @@
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+// 游戏逻辑核心：不依赖 SDL，可在无窗口环境下单独编译运行
+
+#include <climits>
+#include <cstdint>
+
+// 常量定义
+constexpr int Width_Window = 1600;
+constexpr int Height_Window = 350;
+constexpr int MinInterval_Half = 100;   // 障碍物最小间距的一半，默认值；运行时取 GameGeometry::min_interval_half
+constexpr int mFPS = 40;
+constexpr int V = 6;
+constexpr int Tan = 5;
+
+// 与 SDL_Rect 内存布局一致的矩形
+struct GameRect {
+    int x, y, w, h;
+};
+
+constexpr int kObstacleKinds = 7;           // 地面障碍物种类，对应 GameGeometry::obstacles
+constexpr int kBirdKind = kObstacleKinds;   // 鸟
+constexpr int kMaxObstacles = 32;
+
+// 场上的障碍物，结构数组，按 x 升序（下标 0 最靠左）。
+// 所有障碍物同速左移、新障碍物总在最右侧生成，追加到末尾、从头部移除即可保持有序；
+// ahead 指向恐龙前方最近的一个，每个 tick 只会向后移动，查询最近距离为 O(1)
+struct ObstaclePool {
+    int count;
+    int ahead;                      // 第一个左边缘在恐龙右边缘之前的障碍物，等于 count 表示前方没有
+    int front;                      // 恐龙右边缘的 x
+    int countdown;                  // 距下一个生成窗口还要前进的像素
+    uint32_t next_serial;
+    int8_t kind[kMaxObstacles];     // 0 ~ kObstacleKinds-1 为地面障碍物，kBirdKind 为鸟
+    uint32_t serial[kMaxObstacles]; // 生成序号，插值时用来对应前后两个 tick 中的同一个障碍物
+    int x[kMaxObstacles];
+    int y[kMaxObstacles];
+    int w[kMaxObstacles];
+    int h[kMaxObstacles];
+
+    GameRect Rect(int i) const { return GameRect{x[i], y[i], w[i], h[i]}; }
+};
+
+// 恐龙的绘制姿态，由 GameStep 决定，渲染器只读
+enum class DinoPose {
+    Running,
+    Jumping,
+    Crouching,
+};
+
+// 由贴图尺寸决定的静态几何，窗口模式从贴图读取，无头模式用 DefaultGeometry()
+struct GameGeometry {
+    GameRect dino_menu;         // 菜单恐龙位置，y 即地面高度
+    GameRect dino[2];           // [0] 站立/跳跃  [1] 下蹲
+    GameRect road;              // 单块跑道
+    GameRect cloud;             // 云
+    GameRect obstacles[kObstacleKinds];     // 各障碍物，y 已对齐地面
+    GameRect birds[2];          // 鸟的两帧（尺寸相同），y 为飞行高度
+    // 难度参数
+    int min_interval_half;      // 障碍物最小间距的一半，上限见 MaxMinIntervalHalf
+    int spawn_spacing;          // 相邻两个生成窗口的间距（px），默认 Width_Window / 2，越小越密
+    int bird_percent;           // 生成鸟的概率（%），默认 0
+};
+
+// 会话记录中 GameGeometry 逐项写出的项数；GameGeometry 增删字段时须同步修改 GeometryField
+constexpr int kGeometryFields = 4 * (5 + kObstacleKinds + 2) + 3;
+
+// 一个 tick 的输入
+struct GameInput {
+    bool jump;      // 触发跳跃（键盘或解码器）
+    bool down;      // 下蹲键是否按住
+};
+
+// 一局游戏的全部可变状态
+struct GameState {
+    bool jump, down, crouch, collision;
+    int j, life;
+    unsigned long score_m;
+    unsigned int r;
+    double rate;
+    double std_;
+    uint64_t rng;       // 障碍物随机数状态，每个 GameState 独立，多实例并行时互不影响
+
+    GameRect dino[2];
+    GameRect road[2];
+    GameRect cloud[4];
+    ObstaclePool obstacles;
+
+    DinoPose pose;
+    int pose_frame;     // 跑动/下蹲动画帧
+};
+
+GameGeometry DefaultGeometry();
+void GameReset(GameState& state, const GameGeometry& geo);   // 不改动随机数状态，连续多局共用一个序列
+void GameSeed(GameState& state, uint64_t seed);
+void GameStep(GameState& state, const GameGeometry& geo, const GameInput& input);   // 推进一个 tick
+bool GameCollide(GameState& state);     // 碰撞检测（下蹲时用下蹲的矩形），撞上时扣一条命
+// 渲染用：在相邻两个 tick 之间按 alpha 插值位置，跨越回卷或重新生成的物体直接取当前值
+GameState GameInterpolate(const GameState& previous, const GameState& current, double alpha);
+// 逐字段的 FNV-1a 校验和（跳过结构体填充），回放时比较两份状态是否逐位一致
+uint64_t GameChecksum(const GameState& state);
+int MaxMinIntervalHalf(const GameGeometry& geo);
+// 按固定编号取 GameGeometry 的一项，会话记录按此编号写入和读回，与结构体布局无关；
+// 新字段只能追加在末尾。编号越界返回 nullptr
+int* GeometryField(GameGeometry& geo, int index);   // 给定 spawn_spacing 时 min_interval_half 的上限（含）
+bool HasIntersection(const GameRect& a, const GameRect& b);
+
+// 恐龙右边缘到前方最近障碍物左边缘的距离，前方没有障碍物时为 INT_MAX
+inline int calculateDistance(const GameState& state) {
+    const ObstaclePool& pool = state.obstacles;
+    return pool.ahead < pool.count ? pool.x[pool.ahead] - pool.front : INT_MAX;
+}
+
+// 按当前速度还要多少个 tick 撞上最近障碍物，前方没有障碍物时为 INT_MAX；换算成秒再除以 mFPS * rate
+inline int TicksToCollision(const GameState& state) {
+    const int distance = calculateDistance(state);
+    return distance == INT_MAX ? distance : (distance + V - 1) / V;
+}
+
+#endif
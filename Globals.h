@@ -8,39 +8,32 @@
 #include <ctime>
 #include <thread>
 #include <atomic>
+#include <climits>
+#include <cstdint>
+#include "SpscRing.h"
+#include "GameState.h"
+#include "Latency.h"
+#include "SpikeRecorder.h"
+#include "StimPolicy.h"
+#include "Wells.h"
+#include "Metrics.h"
+#include "StimResponse.h"
 
 
-// 常量定义
-constexpr int Width_Window = 1600;
-constexpr int Height_Window = 350;
-constexpr int MinInterval_Half = 100;
-constexpr int mFPS = 40;
-constexpr int V = 6;
-constexpr int Tan = 5;
-
 // 声明全局变量
-extern bool down, crouch, collision;
-extern int j, life;
-extern unsigned long score_m;
+extern GameState game_state;        // 当前这局游戏
+extern GameGeometry game_geometry;  // 由贴图尺寸得到的几何
 extern unsigned long highestscore;
-extern unsigned int r;
-extern unsigned long r_bird[3];
-extern double rate;
-extern double std_;
 extern char Score[7];
 extern char HI[10];
 extern bool detect[3];
 
-extern clock_t FDurTime;
 
 extern SDL_Color Score_Color;
 extern SDL_Color Gameover_Color;
 
 // 游戏状态相关变量
 extern SDL_Rect Dino_menu_Rect;
-extern SDL_Rect Road_Rect[2];
-extern SDL_Rect Cloud_Rect[4];
-extern SDL_Rect TheDINO_Rect[2];
 extern SDL_Rect running_rect[2];
 extern SDL_Rect crouching_rect[2];
 extern SDL_Rect Obstacles_Rect[14];
@@ -52,53 +45,50 @@ extern SDL_Rect Score_Rect;
 extern SDL_Rect HI_Rect;
 extern SDL_Rect Gameover_Rect;
 
-extern SDL_Surface* Birds_Surface;
-extern SDL_Texture* Birds_Texture;
-extern SDL_Surface* Blinking_Surface;
-extern SDL_Texture* Blinking_Texture;
-extern SDL_Surface* Cloud_Surface;
-extern SDL_Texture* Cloud_Texture;
-extern SDL_Surface* Crouching_Surface;
-extern SDL_Texture* Crouching_Texture;
-extern SDL_Surface* Dino_menu_Surface;
-extern SDL_Texture* Dino_menu_Texture;
-extern SDL_Surface* Hit_Surface;
-extern SDL_Texture* Hit_Texture;
-extern SDL_Surface* Restart_Surface;
-extern SDL_Texture* Restart_Texture;
-extern SDL_Surface* Road_Surface;
-extern SDL_Texture* Road_Texture;
-extern SDL_Surface* Running_Surface;
-extern SDL_Texture* Running_Texture;
-
-extern SDL_Surface* Obstacle_Surface[7];
-extern SDL_Texture* Obstacle_Texture[7];
-extern SDL_Surface* Score_Surface;
-extern SDL_Texture* Score_Texture;
-extern SDL_Surface* HI_Surface;
-extern SDL_Texture* HI_Texture;
-extern SDL_Surface* Gameover_Surface;
-extern SDL_Texture* Gameover_Texture;
+
 
 extern Mix_Music* Bgm;
 extern TTF_Font* Score_Font;
 extern TTF_Font* Gameover_Font;
 
-struct use {
-    int Obstacle_i;
-    int space;
-    bool detect;
-    SDL_Rect Rect[2];
+// 解码器给出的动作
+enum class DecoderAction : uint8_t {
+    None = 0,
+    Jump = 1,
+};
+
+// 采集线程 -> 游戏线程的解码事件
+struct DecoderEvent {
+    uint64_t frame;         // 放大器帧号
+    uint32_t spikes;        // 该帧的 spike 数
+    DecoderAction action;
+    uint64_t recv_ns;       // 收到帧的时刻（MonotonicNs）
+    uint64_t decide_ns;     // 做出解码决定的时刻
+    uint64_t push_ns;       // 入队时刻
 };
 
-extern use Obstacle_Use[3];
+// 采集线程与游戏线程之间每个井的通道
+struct WellLink {
+    SpscRing<DecoderEvent, 1024> decoder_events;   // 游戏每个 tick 取空
+    std::atomic<uint64_t> cross_ns{0};             // 最近一次障碍物越过 200 px 的时刻
+    std::atomic<int> obstacle_distance{INT_MAX};   // 游戏线程每个 tick 发布的最近障碍物距离，采集线程每帧读取
+    StimResponse response;                         // 在线 PSTH，采集线程写，任意线程查询诱发响应
+};
 
 extern std::thread t;
-extern std::atomic<int> spikes_count;
 extern std::atomic<bool> stop_thread;
-extern std::atomic<bool> jump;
+extern WellLayout well_layout;                        // DINO_WELLS，启动时读取一次
+extern WellLink well_links[kMaxWells];                // 按 well_layout 中的路编号
+extern std::atomic<uint64_t> acq_frame;               // 采集线程最新处理到的帧号
+extern LatencyStats latency;                          // 闭环各段延迟
+extern SpikeRecorder recorder;                        // 会话记录，DINO_RECORD_DIR 未设置时不启用
+extern MetricsPublisher metrics;                      // 运行时计数器，Dino_dash 读取
+extern StimPolicyStore stim_policies;                 // 距离 -> 刺激策略，开局时按修改时间重新加载
+
+const char* StimPolicyPath();                         // DINO_STIM_POLICY，默认 stim_policy.cfg
+uint64_t SessionSeed();                               // DINO_SEED，未设置时取随机值；第 n 局的种子为它加 n
+void GameDifficultyFromEnv(GameGeometry& geo);        // DINO_SPAWN_SPACING / DINO_BIRD_PERCENT，非法值保留默认
 
-extern int calculateDistance(SDL_Rect dino, struct use *obstacles); // 声明 calculateDistance 函数
 extern void message_thread();
 
 #endif // GLOBALS_H
\ No newline at end of file
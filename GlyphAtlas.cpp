@@ -0,0 +1,101 @@
+#include "GlyphAtlas.h"
+#include <iostream>
+
+void GlyphAtlas::Reset() {
+    for (Glyph& glyph : glyphs_) {
+        glyph = Glyph{};
+    }
+    height_ = 0;
+    space_ = 0;
+}
+
+// surface 交给图集，Build 后释放；nullptr 表示只占位（空格）
+void GlyphAtlas::AddGlyph(SpriteAtlas& atlas, unsigned char c, SDL_Surface* surface, int advance) {
+    glyphs_[c] = Glyph{-1, advance, 0, 0, true};
+    if (surface == nullptr) {
+        return;
+    }
+    if (surface->h > height_) {
+        height_ = surface->h;
+    }
+    glyphs_[c].w = surface->w;
+    glyphs_[c].h = surface->h;
+    glyphs_[c].sprite = atlas.Add(surface, true);
+}
+
+bool GlyphAtlas::Build(SpriteAtlas& atlas, TTF_Font* font, SDL_Color color, const char* charset) {
+    Reset();
+    if (font == nullptr) {
+        return false;
+    }
+
+    bool ok = true;
+    height_ = TTF_FontHeight(font);
+    for (const char* p = charset; *p; ++p) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (c >= 128 || glyphs_[c].present) {
+            continue;
+        }
+        int minx, maxx, miny, maxy, advance;
+        if (TTF_GlyphMetrics(font, c, &minx, &maxx, &miny, &maxy, &advance) != 0) {
+            continue;
+        }
+        SDL_Surface* surface = nullptr;
+        if (c != ' ') {     // 空格只占位，不需要像素
+            surface = TTF_RenderGlyph_Blended(font, c, color);
+            if (surface == nullptr) {
+                std::cerr << "Failed to render glyph '" << c << "': " << TTF_GetError() << std::endl;
+                ok = false;
+                continue;
+            }
+        }
+        AddGlyph(atlas, c, surface, advance);
+    }
+    space_ = glyphs_[' '].present ? glyphs_[' '].advance : glyphs_['0'].advance;
+    return ok;
+}
+
+bool GlyphAtlas::Build(SpriteAtlas& atlas, const AssetPack& pack, const char* font, const char* charset) {
+    Reset();
+    bool ok = true;
+    for (const char* p = charset; *p; ++p) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        const PackEntry* entry = c < 128 ? pack.Glyph(font, *p) : nullptr;
+        if (entry == nullptr) {
+            std::cerr << "Glyph '" << *p << "' missing from asset pack" << std::endl;
+            ok = false;
+            continue;
+        }
+        if (entry->line_height > height_) {
+            height_ = entry->line_height;
+        }
+        AddGlyph(atlas, c, pack.Surface(entry), entry->advance);
+    }
+    space_ = glyphs_[' '].present ? glyphs_[' '].advance : glyphs_['0'].advance;
+    return ok;
+}
+
+int GlyphAtlas::TextWidth(const char* text) const {
+    int width = 0;
+    for (const char* p = text; *p; ++p) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        width += c < 128 && glyphs_[c].present ? glyphs_[c].advance : space_;
+    }
+    return width;
+}
+
+void GlyphAtlas::Draw(SpriteBatch& batch, const char* text, int x, int y) const {
+    for (const char* p = text; *p; ++p) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (c >= 128 || !glyphs_[c].present) {
+            x += space_;
+            continue;
+        }
+        const Glyph& glyph = glyphs_[c];
+        if (glyph.sprite >= 0) {
+            SDL_Rect dst{x, y, glyph.w, glyph.h};
+            batch.Add(glyph.sprite, nullptr, dst);
+        }
+        x += glyph.advance;
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include "SpriteAtlas.h"
+#include "AssetPack.h"
+
+// 把一组字符预先渲染后登记进贴图图集，绘制文字时只按字符往批次里加四边形，
+// 每帧不再创建 surface/texture，也不上传像素
+class GlyphAtlas {
+public:
+    // 图集 Build 之前调用一次；charset 为需要的 ASCII 字符
+    bool Build(SpriteAtlas& atlas, TTF_Font* font, SDL_Color color, const char* charset);     // 运行时光栅化
+    bool Build(SpriteAtlas& atlas, const AssetPack& pack, const char* font, const char* charset);  // 取资源包中的字符
+
+    int TextWidth(const char* text) const;
+    int Height() const { return height_; }
+
+    // 以 (x, y) 为左上角绘制；不在字符集里的字符跳过一个空格宽度
+    void Draw(SpriteBatch& batch, const char* text, int x, int y) const;
+
+private:
+    void Reset();
+    void AddGlyph(SpriteAtlas& atlas, unsigned char c, SDL_Surface* surface, int advance);
+
+    struct Glyph {
+        int sprite;     // 图集中的编号，-1 表示没有像素（空格）
+        int advance;
+        int w, h;
+        bool present;
+    };
+
+    Glyph glyphs_[128] = {};
+    int height_ = 0;
+    int space_ = 0;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#include "Headless.h"
+#include <chrono>
+
+HeadlessResult RunHeadless(const HeadlessOptions& options, const GameGeometry& geo) {
+    HeadlessResult result;
+    GameState state;
+    GameReset(state, geo);
+    GameSeed(state, options.seed);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t tick = 0; tick < options.ticks; ++tick) {
+        GameInput input{false, false};
+        if (options.autopilot_distance > 0 && !state.jump) {
+            int distance = calculateDistance(state);
+            const ObstaclePool& pool = state.obstacles;
+            const int passing = pool.ahead - 1;
+            if (passing >= 0 && pool.kind[passing] == kBirdKind && pool.x[passing] + pool.w[passing] > state.dino[0].x) {
+                input.down = true;      // 鸟还在头顶，保持蹲下
+            } else if (distance < options.autopilot_distance) {
+                // 鸟从头顶飞过，蹲下躲；跳起来反而会撞上
+                if (pool.kind[pool.ahead] == kBirdKind) {
+                    input.down = true;
+                } else {
+                    input.jump = true;
+                    ++result.jumps;
+                }
+            }
+        }
+
+        GameStep(state, geo, input);
+        if (GameCollide(state)) {
+            ++result.collisions;
+        }
+
+        if (state.life < 0) {
+            ++result.games;
+            if (state.score_m / 5 > result.best_score) {
+                result.best_score = state.score_m / 5;
+            }
+            GameReset(state, geo);
+        }
+    }
+    if (state.score_m / 5 > result.best_score) {
+        result.best_score = state.score_m / 5;
+    }
+
+    result.ticks = options.ticks;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,25 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <cstdint>
+#include "GameState.h"
+
+// 无头模式：不创建窗口、不链接 SDL，只推进 GameState
+struct HeadlessOptions {
+    uint64_t ticks = 100000;        // 总 tick 数
+    unsigned int seed = 1;          // 障碍物随机种子
+    int autopilot_distance = 90;    // 最近障碍物距离小于该值时跳跃，<=0 表示从不跳
+};
+
+struct HeadlessResult {
+    uint64_t ticks = 0;
+    uint64_t games = 0;             // 结束的局数（life < 0）
+    uint64_t collisions = 0;
+    uint64_t jumps = 0;
+    unsigned long best_score = 0;
+    double seconds = 0;             // 墙钟耗时
+};
+
+HeadlessResult RunHeadless(const HeadlessOptions& options, const GameGeometry& geo);
+
+#endif
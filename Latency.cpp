@@ -0,0 +1,91 @@
+#include "Latency.h"
+
+static const char* const kStageNames[LatencyStageCount] = {
+    "recv->decide",
+    "decide->push",
+    "push->consume",
+    "consume->present",
+    "recv->present",
+    "cross200->stim",
+    "recv->stim",
+    "stim queue",
+};
+
+int LatencyHistogram::Index(uint64_t value) {
+    if (value < kSubCount) {
+        return static_cast<int>(value);
+    }
+    const int msb = 63 - __builtin_clzll(value);
+    const int shift = msb - kSubBits;
+    return (shift + 1) * kSubCount + static_cast<int>((value >> shift) & (kSubCount - 1));
+}
+
+uint64_t LatencyHistogram::ValueAt(int index) {
+    if (index < kSubCount) {
+        return index;
+    }
+    const int shift = index / kSubCount - 1;
+    const uint64_t sub = index % kSubCount;
+    return ((kSubCount + sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t ns) {
+    counts_[Index(ns)].fetch_add(1, std::memory_order_relaxed);
+    if (ns > max_.load(std::memory_order_relaxed)) {
+        max_.store(ns, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::Reset() {
+    for (auto& count : counts_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::Count() const {
+    uint64_t total = 0;
+    for (const auto& count : counts_) {
+        total += count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t LatencyHistogram::Percentile(double p) const {
+    const uint64_t total = Count();
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * total + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += counts_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            const uint64_t value = ValueAt(i);
+            return value < Max() ? value : Max();
+        }
+    }
+    return Max();
+}
+
+void LatencyHistogram::Print(FILE* out, const char* name) const {
+    fprintf(out, "%-18s n=%-9lu p50=%9.1f p90=%9.1f p99=%9.1f p99.9=%9.1f max=%9.1f us\n",
+            name, Count(), Percentile(50) / 1e3, Percentile(90) / 1e3, Percentile(99) / 1e3,
+            Percentile(99.9) / 1e3, Max() / 1e3);
+}
+
+void LatencyStats::Reset() {
+    for (auto& stage : stages) {
+        stage.Reset();
+    }
+}
+
+void LatencyStats::Dump(FILE* out) const {
+    fprintf(out, "closed-loop latency:\n");
+    for (int i = 0; i < LatencyStageCount; ++i) {
+        stages[i].Print(out, kStageNames[i]);
+    }
+}
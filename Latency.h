@@ -0,0 +1,62 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// 单调时钟，纳秒
+inline uint64_t MonotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// HDR 风格直方图：按 2 的幂分段，每段 32 个线性子桶，相对误差约 3%
+// 每个直方图只由一个线程写，读取可在任意线程
+class LatencyHistogram {
+public:
+    void Record(uint64_t ns);
+    void Reset();
+
+    uint64_t Count() const;
+    uint64_t Max() const { return max_.load(std::memory_order_relaxed); }
+    uint64_t Percentile(double p) const;    // p 取 0~100
+    void Print(FILE* out, const char* name) const;
+
+private:
+    static constexpr int kSubBits = 5;
+    static constexpr int kSubCount = 1 << kSubBits;
+    static constexpr int kBucketCount = (64 - kSubBits + 1) * kSubCount;
+
+    static int Index(uint64_t value);
+    static uint64_t ValueAt(int index);     // 桶的上界
+
+    std::atomic<uint64_t> counts_[kBucketCount] = {};
+    std::atomic<uint64_t> max_{0};
+};
+
+// 闭环中需要测量的各段延迟
+enum LatencyStage {
+    Stage_Recv_Decide,      // 收到帧 -> 解码决定
+    Stage_Decide_Push,      // 解码决定 -> 事件入队（jump 置位）
+    Stage_Push_Consume,     // 入队 -> 游戏 tick 取出
+    Stage_Consume_Present,  // tick 取出 -> SDL_RenderPresent 返回
+    Stage_Recv_Present,     // 端到端：收到帧 -> 画面上起跳
+    Stage_Cross_Stim,       // 障碍物越过 200 px -> sendSequence 返回
+    Stage_Recv_Stim,        // 收到帧 -> sendSequence 返回（刺激线程）
+    Stage_Queue_Stim,       // 刺激命令入队 -> 刺激线程开始发送
+    LatencyStageCount,
+};
+
+struct LatencyStats {
+    LatencyHistogram stages[LatencyStageCount];
+
+    void Record(LatencyStage stage, uint64_t from_ns, uint64_t to_ns) {
+        stages[stage].Record(to_ns > from_ns ? to_ns - from_ns : 0);
+    }
+    void Reset();
+    void Dump(FILE* out) const;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include "Metrics.h"
+#include "Latency.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+const char* MetricsNameFromEnv() {
+    const char* name = getenv("DINO_METRICS");
+    return name ? name : "/dino_metrics";
+}
+
+MetricsPublisher::MetricsPublisher() {
+    memcpy(local_.magic, kMetricsMagic, sizeof(kMetricsMagic));
+    local_.version = kMetricsVersion;
+}
+
+MetricsPublisher::~MetricsPublisher() {
+    Close();
+}
+
+bool MetricsPublisher::Open(const char* name, const WellLayout& layout) {
+    Close();
+    if (name == nullptr || *name == '\0') {
+        return false;
+    }
+    // 上次异常退出留下的同名段直接截断重建
+    const int fd = shm_open(name, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Failed to create metrics segment %s\n", name);
+        return false;
+    }
+    void* map = MAP_FAILED;
+    if (ftruncate(fd, 0) == 0 && ftruncate(fd, sizeof(MetricsSegment)) == 0) {
+        map = mmap(nullptr, sizeof(MetricsSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Failed to map metrics segment %s\n", name);
+        shm_unlink(name);
+        return false;
+    }
+    snprintf(name_, sizeof(name_), "%s", name);
+
+    // ftruncate 后内容全为 0，原子量的初值即为 0；魔数最后写，读者看到魔数时其余头部已就绪
+    MetricsSegment* segment = static_cast<MetricsSegment*>(map);
+    segment->version = kMetricsVersion;
+    segment->wells = layout.count;
+    segment->start_ns = MonotonicNs();
+    memcpy(segment->well_ids, layout.ids, sizeof(segment->well_ids));
+    segment->alive.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(segment->magic, kMetricsMagic, sizeof(kMetricsMagic));
+    segment_ = segment;
+    return true;
+}
+
+void MetricsPublisher::Close() {
+    if (segment_ == &local_) {
+        return;
+    }
+    segment_->alive.store(0, std::memory_order_release);
+    munmap(segment_, sizeof(MetricsSegment));
+    shm_unlink(name_);
+    segment_ = &local_;
+}
+
+void MetricsPublisher::CountStim(const char* name) {
+    MetricsSegment& data = *segment_;
+    Bump(data.stim.stims);
+    const uint32_t count = data.sequence_count.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (strncmp(data.sequence_names[i], name, kMetricsNameBytes - 1) == 0) {
+            Bump(data.stims_by_sequence[i]);
+            return;
+        }
+    }
+    if (count == kMetricsSequences) {
+        return;
+    }
+    snprintf(data.sequence_names[count], kMetricsNameBytes, "%s", name);
+    Bump(data.stims_by_sequence[count]);
+    data.sequence_count.store(count + 1, std::memory_order_release);
+}
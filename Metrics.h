@@ -0,0 +1,121 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include "Wells.h"
+#include "StimResponse.h"
+
+// 运行时计数器和量值，放在 POSIX 共享内存（DINO_METRICS，默认 /dino_metrics）中，看板进程 Dino_dash 只读映射。
+// 每个字段只有一个写者（采集线程、刺激线程或游戏线程），写入是 relaxed 的 load + store，热路径上没有锁也没有原子加；
+// 计数器只增不减，速率由读者按两次采样之差计算。布局变化时增加 kMetricsVersion
+
+constexpr char kMetricsMagic[8] = {'D', 'I', 'N', 'O', 'M', 'E', 'T', '1'};
+constexpr uint32_t kMetricsVersion = 4;
+constexpr int kMetricsSequences = 64;       // 按名字计数的刺激序列数（多井时名字带井号）
+constexpr int kMetricsNameBytes = 32;
+
+using MetricCounter = std::atomic<uint64_t>;
+static_assert(MetricCounter::is_always_lock_free, "共享内存中的计数器必须无锁");
+
+// 单写者计数
+inline void Bump(MetricCounter& counter, uint64_t n = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+inline void Gauge(MetricCounter& gauge, uint64_t value) {
+    gauge.store(value, std::memory_order_relaxed);
+}
+
+// message_thread 写
+struct AcquisitionMetrics {
+    MetricCounter frames;           // 收到的帧
+    MetricCounter empty_polls;      // MAXLAB_NO_FRAME 次数
+    MetricCounter spikes;
+    MetricCounter stims_merged;     // 与未完成的同一刺激合并，未入队
+    MetricCounter stims_dropped;    // 刺激队列满
+    MetricCounter jumps_decoded;
+    MetricCounter last_frame;       // 量值：最新帧号
+    MetricCounter missing_frames;   // 帧号缺口中缺失的帧
+    MetricCounter corrupted_frames; // FrameInfo::corrupted 的原始帧
+    MetricCounter late_frames;      // 处理时已超过 DINO_FRAME_DEADLINE_US 的帧
+    MetricCounter lag_frames;       // 量值：最近一帧落后实时的帧数
+    MetricCounter max_backlog;      // 量值：空轮询之间连续取到的最多帧数
+};
+
+// 刺激线程写
+struct StimMetrics {
+    MetricCounter stims;            // 已调用 sendSequence 的刺激，含失败
+    MetricCounter errors;           // sendSequence 失败
+    MetricCounter queue_ns;         // 累计排队耗时（入队到开始发送）
+    MetricCounter send_ns;          // 累计 sendSequence 耗时
+    MetricCounter send_max_ns;      // 量值：单次 sendSequence 最长耗时
+};
+
+// DinoGame::Play 写
+struct GameMetrics {
+    MetricCounter ticks;
+    MetricCounter overruns;         // 一次循环需要补多个 tick 的次数
+    MetricCounter dropped_ticks;    // 超过补帧上限被丢弃的 tick
+    MetricCounter renders;
+    MetricCounter render_ns;        // 累计渲染耗时（Clear 到 Present 返回）
+    MetricCounter render_max_ns;    // 量值：单帧最长渲染耗时
+    MetricCounter jumps_consumed;   // 游戏取出的解码跳跃
+};
+
+// 每个井一份；stims 由刺激线程写，jumps_decoded 和 evoked_* 由采集线程写，其余由游戏线程写
+struct WellMetrics {
+    MetricCounter stims;
+    MetricCounter jumps_decoded;
+    MetricCounter games;            // 已开始的局数
+    MetricCounter score;            // 量值：当前这局的分数
+    MetricCounter best_score;       // 量值
+    MetricCounter distance;         // 量值：最近障碍物距离，前方没有障碍物时为 INT_MAX
+    MetricCounter evoked_trials[kResponseSequences];    // 按序列号，已结束的刺激窗口数
+    MetricCounter evoked_permille[kResponseSequences];  // 量值：最近刺激后/前发放率之比 × 1000
+};
+
+struct MetricsSegment {
+    char magic[8];
+    uint32_t version;
+    uint32_t wells;
+    uint64_t start_ns;              // MonotonicNs，读者用同一时钟换算运行时长
+    std::atomic<uint32_t> alive;    // 会话结束时清零
+    uint8_t well_ids[kMaxWells];
+
+    AcquisitionMetrics acquisition;
+    StimMetrics stim;
+    GameMetrics game;
+    WellMetrics well[kMaxWells];
+
+    // 刺激按序列名计数。名字由刺激线程在第一次发送时追加，写完名字才增加 sequence_count，
+    // 读者只读前 sequence_count 个
+    std::atomic<uint32_t> sequence_count;
+    char sequence_names[kMetricsSequences][kMetricsNameBytes];
+    MetricCounter stims_by_sequence[kMetricsSequences];
+};
+
+// 创建并映射共享内存段；未启用或创建失败时指向进程内的一份，调用方不必判断
+class MetricsPublisher {
+public:
+    MetricsPublisher();
+    ~MetricsPublisher();
+
+    bool Open(const char* name, const WellLayout& layout);
+    void Close();                   // 标记结束并删除共享内存名
+
+    MetricsSegment& Data() { return *segment_; }
+
+    // 刺激线程调用：按序列名计一次刺激，超出 kMetricsSequences 的名字只计总数
+    void CountStim(const char* name);
+
+private:
+    MetricsSegment local_ = {};
+    MetricsSegment* segment_ = &local_;
+    char name_[64] = {};
+};
+
+// DINO_METRICS：共享内存名，默认 /dino_metrics；设为空串关闭
+const char* MetricsNameFromEnv();
+
+#endif
@@ -0,0 +1,155 @@
+#include "RawDetector.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// 向量宽度跟随目标指令集：有 AVX 时 8 路，否则 4 路（SSE2/NEON）。
+// 宽于硬件寄存器的向量类型会被拆成标量处理，比 4 路还慢得多
+#if defined(__AVX__)
+constexpr int kLanes = 8;
+#else
+constexpr int kLanes = 4;
+#endif
+typedef float f32xN __attribute__((vector_size(kLanes * 4)));
+typedef int32_t i32xN __attribute__((vector_size(kLanes * 4)));
+
+constexpr float kSampleRate = 20000.f;
+constexpr float kPi = 3.14159265358979f;
+
+RawDetectorConfig RawDetectorConfigFromEnv() {
+    RawDetectorConfig config;
+    if (const char* v = getenv("DINO_RAW_LOW_HZ")) config.low_hz = strtof(v, nullptr);
+    if (const char* v = getenv("DINO_RAW_HIGH_HZ")) config.high_hz = strtof(v, nullptr);
+    if (const char* v = getenv("DINO_RAW_THRESHOLD")) config.threshold = strtof(v, nullptr);
+    if (const char* v = getenv("DINO_RAW_REFRACTORY")) config.refractory_frames = strtoul(v, nullptr, 10);
+    if (const char* v = getenv("DINO_RAW_NOISE_MS")) config.noise_tau_ms = strtof(v, nullptr);
+    return config;
+}
+
+RawDetector::RawDetector() {
+    RawDetectorConfig config;
+    Configure(config);
+}
+
+bool RawDetector::Configure(const RawDetectorConfig& config) {
+    if (!(config.low_hz > 0.f && config.low_hz < config.high_hz && config.high_hz < kSampleRate / 2) ||
+        !(config.threshold > 0.f) || !(config.noise_tau_ms > 0.f)) {
+        fprintf(stderr, "Invalid raw detector band %.0f-%.0f Hz / threshold %.1f\n",
+                config.low_hz, config.high_hz, config.threshold);
+        return false;
+    }
+
+    // RBJ 二阶巴特沃斯（Q = 1/sqrt(2)）高通与低通
+    const float q = 0.70710678f;
+    {
+        const float w = 2.f * kPi * config.low_hz / kSampleRate;
+        const float alpha = sinf(w) / (2.f * q), c = cosf(w), a0 = 1.f + alpha;
+        highpass_ = {(1.f + c) / 2.f / a0, -(1.f + c) / a0, (1.f + c) / 2.f / a0, -2.f * c / a0, (1.f - alpha) / a0};
+    }
+    {
+        const float w = 2.f * kPi * config.high_hz / kSampleRate;
+        const float alpha = sinf(w) / (2.f * q), c = cosf(w), a0 = 1.f + alpha;
+        lowpass_ = {(1.f - c) / 2.f / a0, (1.f - c) / a0, (1.f - c) / 2.f / a0, -2.f * c / a0, (1.f - alpha) / a0};
+    }
+
+    threshold_scale_ = config.threshold * sqrtf(kPi / 2.f);
+    noise_alpha_ = 1.f / (config.noise_tau_ms * kSampleRate / 1000.f);
+    refractory_ = static_cast<int32_t>(config.refractory_frames);
+    warmup_ = config.warmup_frames;
+    Reset();
+    return true;
+}
+
+void RawDetector::Reset() {
+    memset(hp_z1_, 0, sizeof(hp_z1_));
+    memset(hp_z2_, 0, sizeof(hp_z2_));
+    memset(lp_z1_, 0, sizeof(lp_z1_));
+    memset(lp_z2_, 0, sizeof(lp_z2_));
+    memset(noise_, 0, sizeof(noise_));
+    memset(below_, 0, sizeof(below_));
+    memset(dead_, 0, sizeof(dead_));
+    frames_ = 0;
+    detected_ = 0;
+}
+
+float RawDetector::Noise(int channel) const {
+    return noise_[channel] * sqrtf(kPi / 2.f);
+}
+
+uint32_t RawDetector::Process(uint64_t frame, const float* amplitudes, uint8_t well_id) {
+    // 预热阶段用累计平均让噪声估计尽快收敛，之后换成固定时间常数
+    const float alpha_scalar = frames_ < warmup_ && 1.f / (frames_ + 1) > noise_alpha_ ? 1.f / (frames_ + 1) : noise_alpha_;
+    const bool detect = frames_ >= warmup_;
+    ++frames_;
+
+    const f32xN hb0 = f32xN{} + highpass_.b0, hb1 = f32xN{} + highpass_.b1, hb2 = f32xN{} + highpass_.b2;
+    const f32xN ha1 = f32xN{} + highpass_.a1, ha2 = f32xN{} + highpass_.a2;
+    const f32xN lb0 = f32xN{} + lowpass_.b0, lb1 = f32xN{} + lowpass_.b1, lb2 = f32xN{} + lowpass_.b2;
+    const f32xN la1 = f32xN{} + lowpass_.a1, la2 = f32xN{} + lowpass_.a2;
+    const f32xN alpha = f32xN{} + alpha_scalar;
+    const f32xN scale = f32xN{} + threshold_scale_;
+    const f32xN zero = f32xN{};
+    const i32xN one = i32xN{} + 1;
+    const i32xN refractory = i32xN{} + refractory_;
+    const i32xN enabled = i32xN{} + (detect ? -1 : 0);
+
+    f32xN* hp_z1 = reinterpret_cast<f32xN*>(hp_z1_);
+    f32xN* hp_z2 = reinterpret_cast<f32xN*>(hp_z2_);
+    f32xN* lp_z1 = reinterpret_cast<f32xN*>(lp_z1_);
+    f32xN* lp_z2 = reinterpret_cast<f32xN*>(lp_z2_);
+    f32xN* noise = reinterpret_cast<f32xN*>(noise_);
+    i32xN* below_prev = reinterpret_cast<i32xN*>(below_);
+    i32xN* dead = reinterpret_cast<i32xN*>(dead_);
+
+    uint32_t count = 0;
+    for (int v = 0; v < kChannelCount / kLanes; ++v) {
+        f32xN x;
+        memcpy(&x, amplitudes + v * kLanes, sizeof(x));     // 输入不保证对齐
+
+        f32xN h = hb0 * x + hp_z1[v];
+        hp_z1[v] = hb1 * x - ha1 * h + hp_z2[v];
+        hp_z2[v] = hb2 * x - ha2 * h;
+
+        f32xN y = lb0 * h + lp_z1[v];
+        lp_z1[v] = lb1 * h - la1 * y + lp_z2[v];
+        lp_z2[v] = lb2 * h - la2 * y;
+
+        // 噪声估计：|y| 截断在阈值处，避免 spike 本身抬高噪声
+        const f32xN mean = noise[v];
+        const f32xN limit = mean * scale;
+        f32xN magnitude = y < zero ? -y : y;
+        if (detect) {
+            magnitude = magnitude < limit ? magnitude : limit;
+        }
+        noise[v] = mean + alpha * (magnitude - mean);
+
+        // 本帧刚越过阈值（上一帧不在阈值以下）且不在不应期
+        const i32xN below = y < -limit;
+        const i32xN fire = below & ~below_prev[v] & (dead[v] < one) & enabled;
+        below_prev[v] = below;
+        const i32xN left = dead[v] - one;
+        dead[v] = fire ? refractory : (left < i32xN{} ? i32xN{} : left);
+
+        // 绝大多数向量没有 spike，只在有越阈通道时逐个展开
+        uint64_t lanes[kLanes / 2];
+        memcpy(lanes, &fire, sizeof(lanes));
+        uint64_t hit = 0;
+        for (int i = 0; i < kLanes / 2; ++i) {
+            hit |= lanes[i];
+        }
+        if (hit != 0) {
+            for (int lane = 0; lane < kLanes; ++lane) {
+                if (fire[lane]) {
+                    maxlab::SpikeEvent& event = spikes_[count++];
+                    event.frameNo = frame;
+                    event.amp = y[lane];
+                    event.channel = static_cast<uint16_t>(v * kLanes + lane);
+                    event.wellId = well_id;
+                }
+            }
+        }
+    }
+    detected_ += count;
+    return count;
+}
@@ -0,0 +1,63 @@
+#ifndef RAW_DETECTOR_H
+#define RAW_DETECTOR_H
+
+#include <cstdint>
+#include "maxlab/include/maxlab/spike_event.h"
+#include "SpikeDecoder.h"
+
+// 原始流上的 spike 检测参数，阈值与 Dino_Setup.py 中 stream_set_event_threshold 的含义相同（噪声倍数）
+struct RawDetectorConfig {
+    float low_hz = 300.f;           // 带通下限（二阶高通）
+    float high_hz = 3000.f;         // 带通上限（二阶低通）
+    float threshold = 5.f;          // 负向越过 threshold × 噪声标准差时记一个 spike
+    uint32_t refractory_frames = 20;    // 同一通道两次 spike 的最小间隔（20 帧 = 1 ms）
+    float noise_tau_ms = 500.f;     // 噪声估计的时间常数
+    uint32_t warmup_frames = 2000;  // 噪声估计收敛前不检测
+};
+
+// 从 DINO_RAW_LOW_HZ / DINO_RAW_HIGH_HZ / DINO_RAW_THRESHOLD / DINO_RAW_REFRACTORY / DINO_RAW_NOISE_MS 读取
+RawDetectorConfig RawDetectorConfigFromEnv();
+
+// 1024 通道原始流的客户端 spike 检测：
+// 逐通道级联两个双二阶滤波器构成带通，按 |y| 的指数滑动平均估计噪声，负向越阈且不在不应期时输出 SpikeEvent。
+// 所有状态按通道连续存放，每帧对 1024 个通道按 4/8 路向量运算；只有越阈的向量才逐通道检查。
+class RawDetector {
+public:
+    RawDetector();
+
+    bool Configure(const RawDetectorConfig& config);
+    void Reset();
+
+    // 处理一帧 1024 个原始幅值，返回本帧检测到的 spike 数，结果见 Spikes()
+    uint32_t Process(uint64_t frame, const float* amplitudes, uint8_t well_id = 0);
+
+    const maxlab::SpikeEvent* Spikes() const { return spikes_; }
+    float Noise(int channel) const;     // 当前噪声标准差估计
+    uint64_t Detected() const { return detected_; }
+
+private:
+    // 二阶节的系数，差分方程按转置直接 II 型
+    struct Biquad {
+        float b0, b1, b2, a1, a2;
+    };
+
+    Biquad highpass_{};
+    Biquad lowpass_{};
+    float threshold_scale_ = 0.f;   // threshold × sqrt(pi/2)，把 |y| 的均值换算为标准差
+    float noise_alpha_ = 0.f;
+    int32_t refractory_ = 20;
+    uint32_t warmup_ = 2000;
+    uint64_t frames_ = 0;
+    uint64_t detected_ = 0;
+
+    alignas(64) float hp_z1_[kChannelCount];
+    alignas(64) float hp_z2_[kChannelCount];
+    alignas(64) float lp_z1_[kChannelCount];
+    alignas(64) float lp_z2_[kChannelCount];
+    alignas(64) float noise_[kChannelCount];        // |y| 的滑动平均
+    alignas(64) int32_t below_[kChannelCount];      // 上一帧是否在阈值以下（0 / -1）
+    alignas(64) int32_t dead_[kChannelCount];       // 剩余不应期帧数
+    maxlab::SpikeEvent spikes_[kChannelCount];
+};
+
+#endif
@@ -2,15 +2,19 @@
 #include <iostream>
 
 
-Renderer::Renderer() : Window(nullptr), Renderer_(nullptr) {}
+Renderer::Renderer() : Window(nullptr), Renderer_(nullptr), Target_(nullptr) {}
 
 Renderer::~Renderer() {
+    atlas_.Destroy();
     if (Renderer_) {
         SDL_DestroyRenderer(Renderer_);
     }
     if (Window) {
         SDL_DestroyWindow(Window);
     }
+    if (Target_) {
+        SDL_FreeSurface(Target_);
+    }
     SDL_Quit();
 }
 
@@ -36,226 +40,140 @@ bool Renderer::Initialize(const std::string& title, int width, int height) {
     return true;
 }
 
+bool Renderer::InitializeOffscreen(int width, int height) {
+    Target_ = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!Target_) {
+        return false;
+    }
+    Renderer_ = SDL_CreateSoftwareRenderer(Target_);
+    return Renderer_ != nullptr;
+}
+
 void Renderer::Clear() {
     SDL_SetRenderDrawColor(Renderer_, 255, 255, 255, 255);
     SDL_RenderClear(Renderer_);
+    batch_.Begin();
 }
 
 void Renderer::Present() {
+    batch_.Flush(Renderer_);
     SDL_RenderPresent(Renderer_);
 }
 
-void Renderer::LoadTexture(const std::string& filePath, SDL_Texture*& texture, SDL_Rect& rect) {
-    SDL_Surface* surface = IMG_Load(filePath.c_str());
-    texture = SDL_CreateTextureFromSurface(Renderer_, surface);
-    rect = { 0, 0, surface->w, surface->h };
-    SDL_FreeSurface(surface);
+bool Renderer::BuildAtlas(SDL_Surface* const sprites[SpriteCount], TTF_Font* scoreFont, SDL_Color scoreColor) {
+    atlas_.Destroy();
+    for (int i = 0; i < SpriteCount; ++i) {
+        atlas_.Add(sprites[i], true);
+    }
+    const bool glyphs = score_glyphs_.Build(atlas_, scoreFont, scoreColor, kScoreCharset);
+    return atlas_.Build(Renderer_) && glyphs;
 }
 
-void Renderer::RenderTexture(SDL_Texture* texture, SDL_Rect* srcRect, SDL_Rect* dstRect) {
-    SDL_RenderCopy(Renderer_, texture, srcRect, dstRect);
+bool Renderer::BuildAtlas(SDL_Surface* const sprites[SpriteCount], const AssetPack& pack) {
+    atlas_.Destroy();
+    for (int i = 0; i < SpriteCount; ++i) {
+        atlas_.Add(sprites[i], true);
+    }
+    const bool glyphs = score_glyphs_.Build(atlas_, pack, "score", kScoreCharset);
+    return atlas_.Build(Renderer_) && glyphs;
 }
 
-void Renderer::RenderBackground(SDL_Texture* texture, SDL_Rect* rects) {
+void Renderer::RenderSprite(int sprite, const SDL_Rect* srcRect, const SDL_Rect& dstRect) {
+    batch_.Add(sprite, srcRect, dstRect);
+}
+
+void Renderer::RenderSprite(int sprite, const SDL_Rect* srcRect, const GameRect& dstRect) {
+    batch_.Add(sprite, srcRect, ToSDL(dstRect));
+}
+
+void Renderer::RenderBackground(const GameState& state) {
     for (int i = 0; i < 2; i++)
     {
-        Road_Rect[i].x -= V;
-        if (Road_Rect[i].x < -Road_Surface->w)
-        {
-            Road_Rect[i].x += Road_Surface->w * 2;
-        }
-        SDL_RenderCopy(Renderer_, Road_Texture, NULL, Road_Rect + i);
+        RenderSprite(Sprite_Road, NULL, state.road[i]);
     }
 
-
     for (int i = 0; i < 4; i++)
     {
-        Cloud_Rect[i].x -= V / 4;
-        if (Cloud_Rect[i].x < -Cloud_Surface->w)
-        {
-            Cloud_Rect[i].x = Width_Window;
-        }
-        SDL_RenderCopy(Renderer_, Cloud_Texture, NULL, Cloud_Rect + i);
+        RenderSprite(Sprite_Cloud, NULL, state.cloud[i]);
     }
 
 }
 
-void Renderer::RenderObstacle(SDL_Surface* surface[], SDL_Rect rects[], int count) {
-    //Select Obstacle Randomly
-    if (Obstacle_Use[0].space == Width_Window || Obstacle_Use[1].space == Width_Window || Obstacle_Use[2].space == Width_Window)
-    {
-        for (int i = 0; i < 3; i++)
-        {
-            if (Obstacle_Use[i].space == Width_Window)
-            {
-                Obstacle_Use[i].detect = false;
-                int t = score_m > 500 ? 9 : 5;
-                Obstacle_Use[i].Obstacle_i = rand() % 7;
-
-                if (Obstacle_Use[i].Obstacle_i >= 7)//Bird作为Obstacle
-                {
-                    int pre_x = Width_Window + MinInterval_Half + rand() % (Width_Window / 2 - MinInterval_Half * 2 - Birds_Rect[i].w);
-                    //鸟的扇动翅膀动画
-                    for (int h = 0; h < 2; h++)
-                    {
-                        Obstacle_Use[i].Rect[h] = Birds_Rect[h];
-                        Obstacle_Use[i].Rect[h].x = pre_x;
-                    }
-                    break;
-                }
-
-                Obstacle_Use[i].Rect[0] = Obstacles_Rect[Obstacle_Use[i].Obstacle_i];
-                Obstacle_Use[i].Rect->x = Width_Window + MinInterval_Half + rand() % (Width_Window / 2 - MinInterval_Half * 2 - Obstacle_Use[i].Rect->w);
-
-                break;
-            }
-        }
-    }
-    for (int i = 0; i < 3; i++)
+void Renderer::RenderObstacle(const GameState& state) {
+    const ObstaclePool& pool = state.obstacles;
+    for (int i = 0; i < pool.count; i++)
     {
-        Obstacle_Use[i].space -= V;
-
-        if (Obstacle_Use[i].space < -Width_Window / 2)
+        const GameRect rect = pool.Rect(i);
+        if (pool.kind[i] == kBirdKind)
         {
-            Obstacle_Use[i].space = Width_Window;
+            // 每跑 16 个分数单位扇一次翅膀
+            RenderSprite(Sprite_Birds, birds_rect + (state.score_m / 16) % 2, rect);
         }
-
-        if (Obstacle_Use[i].Obstacle_i > -1)
+        else
         {
-            if (Obstacle_Use[i].Obstacle_i >= 7)
-            {
-                r_bird[i] >>= 1;
-                if (r_bird[i] == 0)
-                {
-                    r_bird[i] = 2147516415;
-                }
-                Obstacle_Use[i].Rect[0].x -= V;
-                Obstacle_Use[i].Rect[1].x -= V;
-
-                SDL_RenderCopy(Renderer_, Birds_Texture, birds_rect + r_bird[i] % 2, Obstacle_Use[i].Rect + r_bird[i] % 2);
-            }
-            else
-            {
-                Obstacle_Use[i].Rect->x -= V;
-
-                SDL_RenderCopy(Renderer_, Obstacle_Texture[Obstacle_Use[i].Obstacle_i], NULL, Obstacle_Use[i].Rect);
-            }
+            RenderSprite(Sprite_Obstacle + pool.kind[i], NULL, rect);
         }
     }
 }
 
-void Renderer::RenderDino(SDL_Texture* texture, SDL_Rect* rect) {
-    if (down)
+void Renderer::RenderDino(const GameState& state) {
+    switch (state.pose)
     {
-        if (jump && TheDINO_Rect[0].y != Dino_menu_Rect.y)//Rapidly Drop
-        {
-            j = j <= V * Tan ? 2 * V * Tan + 1 - j : j;
-            for (int i = 0; i < 3 && jump; i++)
-            {
-                std_ += (j - V * Tan) * 2 * Height_Window / (double)(3 * V * Tan * V * Tan);
-                TheDINO_Rect[0].y = std_;
-                j++;
-                if (j == 2 * V * Tan + 1)
-                {
-                    j = 0;
-                    TheDINO_Rect->y = Dino_menu_Rect.y;//Reset TheDINO_Rect[0].y(bug来自于std取整)
-                    jump = false;
-                }
-            }
-            SDL_RenderCopy(Renderer_, Blinking_Texture, NULL, TheDINO_Rect);
-        }
-        else//Crouch
-        {
-            SDL_RenderCopy(Renderer_, Crouching_Texture, crouching_rect + r % 2, TheDINO_Rect + 1);
-            r >>= 1;
-            if (r == 16)
-            {
-                r = 4111;
-            }
-            jump = false;
-            crouch = true;
-        }
-    }
-    else if (jump)
-    {
-        std_ += (j - V * Tan) * 2 * Height_Window / (double)(3 * V * Tan * V * Tan);
-        TheDINO_Rect[0].y = std_;
-        j++;
-        SDL_RenderCopy(Renderer_, Blinking_Texture, NULL, TheDINO_Rect);
-        if (j == 2 * V * Tan + 1)
-        {
-            j = 0;
-            TheDINO_Rect->y = Dino_menu_Rect.y;//Reset TheDINO_Rect[0].y(bug来自于std取整)
-            jump = false;
-        }
-    }
-    else//Running
-    {
-        SDL_RenderCopy(Renderer_, Running_Texture, running_rect + r % 2, TheDINO_Rect);
-        r >>= 1;
-        if (r == 16)
-        {
-            r = 4111;
-        }
+        case DinoPose::Jumping:
+            RenderSprite(Sprite_Blinking, NULL, state.dino[0]);
+            break;
+
+        case DinoPose::Crouching:
+            RenderSprite(Sprite_Crouching, crouching_rect + state.pose_frame, state.dino[1]);
+            break;
+
+        case DinoPose::Running:
+            RenderSprite(Sprite_Running, running_rect + state.pose_frame, state.dino[0]);
+            break;
     }
 }
 
-void Renderer::RenderScore(unsigned long score, TTF_Font* font, SDL_Rect& Score_Rect) {
-    std::string Score(7,'0') ;
+void Renderer::RenderScore(unsigned long score, SDL_Rect& Score_Rect) {
+    char Score[8] = "0000000";
     for (int i = 5; i >= 0 && score != 0; i--)
     {
         Score[i] = score % 10 + '0';
         score /= 10;
     }
 
-    SDL_Surface* Score_Surface = TTF_RenderUTF8_Blended(font, Score.c_str(), Score_Color);
-    if (Score_Surface == nullptr) {
-        std::cerr << "Failed to render score surface: " << TTF_GetError() << std::endl;
-        return;
-    }
-    SDL_Texture* Score_Texture = SDL_CreateTextureFromSurface(Renderer_, Score_Surface);
-    Score_Rect = SDL_Rect{ Width_Window - Score_Surface->w - 20,20,Score_Surface->w,Score_Surface->h };
-    
-
-    SDL_Surface* HI_Surface = TTF_RenderUTF8_Blended(Score_Font, HI, Score_Color);
-    if (HI_Surface == nullptr) {
-        std::cerr << "Failed to render HI surface: " << TTF_GetError() << std::endl;
-        return;
-    }
-    SDL_Texture* HI_Texture = SDL_CreateTextureFromSurface(Renderer_, HI_Surface);
-    HI_Rect = SDL_Rect{Width_Window * 0.8 - HI_Surface->w -20 ,20,HI_Surface->w,HI_Surface->h };
-    
-
-    SDL_RenderCopy(Renderer_, Score_Texture, nullptr, &Score_Rect);
-    SDL_RenderCopy(Renderer_, HI_Texture, NULL, &HI_Rect);
+    const int score_w = score_glyphs_.TextWidth(Score);
+    Score_Rect = SDL_Rect{ Width_Window - score_w - 20, 20, score_w, score_glyphs_.Height() };
+    const int hi_w = score_glyphs_.TextWidth(HI);
+    HI_Rect = SDL_Rect{ static_cast<int>(Width_Window * 0.8) - hi_w - 20, 20, hi_w, score_glyphs_.Height() };
 
-    SDL_FreeSurface(Score_Surface);
-    SDL_DestroyTexture(Score_Texture);
-    
+    score_glyphs_.Draw(batch_, Score, Score_Rect.x, Score_Rect.y);
+    score_glyphs_.Draw(batch_, HI, HI_Rect.x, HI_Rect.y);
 }
 
-void Renderer::RenderGameover(SDL_Texture* hitTexture, SDL_Texture* gameoverTexture, SDL_Texture* restartTexture, SDL_Rect& hitRect, SDL_Rect& gameoverRect, SDL_Rect& restartRect, bool crouch, SDL_Rect* theDinoRect, SDL_Surface* hitSurface) {
-    if (crouch) {
-        hitRect = { theDinoRect[1].x + theDinoRect[1].w - hitSurface->w, theDinoRect[1].y + 2, hitSurface->w, hitSurface->h };
+void Renderer::RenderGameover(SDL_Rect& hitRect, SDL_Rect& gameoverRect, SDL_Rect& restartRect, const GameState& state) {
+    const SDL_Rect& hit = atlas_.Rect(Sprite_Hit);
+    if (state.crouch) {
+        hitRect = { state.dino[1].x + state.dino[1].w - hit.w, state.dino[1].y + 2, hit.w, hit.h };
     } else {
-        hitRect = { theDinoRect[0].x + theDinoRect[0].w - hitSurface->w, theDinoRect[0].y, hitSurface->w, hitSurface->h };
+        hitRect = { state.dino[0].x + state.dino[0].w - hit.w, state.dino[0].y, hit.w, hit.h };
     }
-    SDL_RenderCopy(Renderer_, hitTexture, NULL, &hitRect);
-    SDL_RenderCopy(Renderer_, gameoverTexture, NULL, &gameoverRect);
-    SDL_RenderCopy(Renderer_, restartTexture, NULL, &restartRect);
-    SDL_RenderPresent(Renderer_);
+    RenderSprite(Sprite_Hit, NULL, hitRect);
+    RenderSprite(Sprite_Gameover, NULL, gameoverRect);
+    RenderSprite(Sprite_Restart, NULL, restartRect);
+    Present();
 }
 
-void Renderer::RenderPause(SDL_Texture* hitTexture,  SDL_Rect& hitRect,  bool crouch, SDL_Rect* theDinoRect, SDL_Surface* hitSurface) {
-    if (crouch) {
-        hitRect = { theDinoRect[1].x + theDinoRect[1].w - hitSurface->w, theDinoRect[1].y + 2, hitSurface->w, hitSurface->h };
+void Renderer::RenderPause(SDL_Rect& hitRect, const GameState& state) {
+    const SDL_Rect& hit = atlas_.Rect(Sprite_Hit);
+    if (state.crouch) {
+        hitRect = { state.dino[1].x + state.dino[1].w - hit.w, state.dino[1].y + 2, hit.w, hit.h };
     } else {
-        hitRect = { theDinoRect[0].x + theDinoRect[0].w - hitSurface->w, theDinoRect[0].y, hitSurface->w, hitSurface->h };
+        hitRect = { state.dino[0].x + state.dino[0].w - hit.w, state.dino[0].y, hit.w, hit.h };
     }
-    SDL_RenderCopy(Renderer_, hitTexture, NULL, &hitRect);
-    // SDL_RenderCopy(Renderer_, gameoverTexture, NULL, &gameoverRect);
-    // SDL_RenderCopy(Renderer_, restartTexture, NULL, &restartRect);
-    SDL_RenderPresent(Renderer_);
+    RenderSprite(Sprite_Hit, NULL, hitRect);
+    // RenderSprite(Sprite_Gameover, NULL, gameoverRect);
+    // RenderSprite(Sprite_Restart, NULL, restartRect);
+    Present();
 }
 
 void Renderer::DestroyTexture(SDL_Texture*& texture) {
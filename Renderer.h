@@ -7,23 +7,52 @@
 #include <SDL2/SDL_mixer.h>
 #include <string>
 #include "Globals.h"
+#include "GlyphAtlas.h"
+#include "SpriteAtlas.h"
 
+// GameRect 转成 SDL 的矩形
+inline SDL_Rect ToSDL(const GameRect& rect) {
+    return SDL_Rect{rect.x, rect.y, rect.w, rect.h};
+}
+
+// 图集中的贴图编号，与 DinoGame::PrepareAll 登记顺序一致
+enum SpriteId {
+    Sprite_Blinking,
+    Sprite_Birds,
+    Sprite_Cloud,
+    Sprite_Crouching,
+    Sprite_DinoMenu,
+    Sprite_Hit,
+    Sprite_Restart,
+    Sprite_Road,
+    Sprite_Running,
+    Sprite_Obstacle,                    // Obstacle_a ~ Obstacle_g 共 7 个
+    Sprite_Gameover = Sprite_Obstacle + 7,
+    SpriteCount,
+};
+
+// Clear 与 Present 之间的所有绘制攒进同一个批次，Present 时一次提交
 class Renderer {
 public:
     Renderer();
     ~Renderer();
 
     bool Initialize(const std::string& title, int width, int height);
+    bool InitializeOffscreen(int width, int height);    // 不开窗口，软件渲染到内存中的 surface，供基准测试使用
     void Clear();
     void Present();
-    void LoadTexture(const std::string& filePath, SDL_Texture*& texture, SDL_Rect& rect);
-    void RenderTexture(SDL_Texture* texture, SDL_Rect* srcRect, SDL_Rect* dstRect);
-    void RenderBackground(SDL_Texture* texture, SDL_Rect* rects);
-    void RenderObstacle(SDL_Surface* surface[], SDL_Rect rects[], int count);
-    void RenderDino(SDL_Texture* texture, SDL_Rect* rect);
-    void RenderScore(unsigned long score, TTF_Font* font, SDL_Rect& rect);
-    void RenderGameover(SDL_Texture* hitTexture, SDL_Texture* gameoverTexture, SDL_Texture* restartTexture, SDL_Rect& hitRect, SDL_Rect& gameoverRect, SDL_Rect& restartRect, bool crouch, SDL_Rect* theDinoRect, SDL_Surface* hitSurface);
-    void RenderPause(SDL_Texture* hitTexture, SDL_Rect& hitRect, bool crouch, SDL_Rect* theDinoRect, SDL_Surface* hitSurface) ;
+    // 加载时调用一次：登记全部贴图和分数字符，拼成一张纹理；sprites 中的 surface 由图集接管并在上传后释放
+    bool BuildAtlas(SDL_Surface* const sprites[SpriteCount], TTF_Font* scoreFont, SDL_Color scoreColor);
+    bool BuildAtlas(SDL_Surface* const sprites[SpriteCount], const AssetPack& pack);
+    const SDL_Rect& SpriteRect(int sprite) const { return atlas_.Rect(sprite); }
+    void RenderSprite(int sprite, const SDL_Rect* srcRect, const SDL_Rect& dstRect);
+    void RenderSprite(int sprite, const SDL_Rect* srcRect, const GameRect& dstRect);
+    void RenderBackground(const GameState& state);
+    void RenderObstacle(const GameState& state);
+    void RenderDino(const GameState& state);
+    void RenderScore(unsigned long score, SDL_Rect& rect);
+    void RenderGameover(SDL_Rect& hitRect, SDL_Rect& gameoverRect, SDL_Rect& restartRect, const GameState& state);
+    void RenderPause(SDL_Rect& hitRect, const GameState& state);
     void DestroyTexture(SDL_Texture*& texture);
 
     SDL_Renderer* GetRenderer() const;
@@ -35,6 +64,10 @@ public:
 private:
     SDL_Window* Window;
     SDL_Renderer* Renderer_;
+    SDL_Surface* Target_;       // InitializeOffscreen 的渲染目标
+    SpriteAtlas atlas_;         // 全部贴图和分数字符
+    SpriteBatch batch_{atlas_};
+    GlyphAtlas score_glyphs_;   // 分数和 HI 用到的字符
 };
 
 #endif
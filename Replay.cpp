@@ -0,0 +1,181 @@
+#include "Replay.h"
+#include <algorithm>
+
+bool LoadRecordedSession(const SessionReader& reader, RecordedSession& session) {
+    session = RecordedSession();
+    bool geometry_seen[kGeometryFields] = {};
+    int current[256];   // 各井正在进行的一局在 games 中的下标
+    std::fill(current, current + 256, -1);
+
+    for (const BlockHeader* block : reader.Blocks()) {
+        if (block->kind != Block_Events) {
+            continue;
+        }
+        const EventColumns events = EventBlockColumns(block);
+        for (uint32_t i = 0; i < block->count; ++i) {
+            const int64_t value = events.values[i];
+            const uint8_t well = events.wells[i];
+            RecordedGame* game = current[well] >= 0 ? &session.games[current[well]] : nullptr;
+            switch (events.types[i]) {
+                case Event_Geometry: {
+                    const int64_t index = value >> 32;
+                    int* field = index < kGeometryFields ? GeometryField(session.geometry, static_cast<int>(index)) : nullptr;
+                    if (field == nullptr) {
+                        session.geometry_mismatch = true;
+                        break;
+                    }
+                    *field = static_cast<int>(static_cast<uint32_t>(value));
+                    geometry_seen[index] = true;
+                    break;
+                }
+                case Event_Seed:
+                    current[well] = static_cast<int>(session.games.size());
+                    session.games.emplace_back();
+                    session.games.back().well = well;
+                    session.games.back().seed = static_cast<uint64_t>(value);
+                    if (well != session.games.front().well) {
+                        session.multiwell = true;
+                    }
+                    break;
+                case Event_Input:
+                    if (game != nullptr) {
+                        const uint64_t tick = static_cast<uint64_t>(value) >> 8;
+                        // 中间有记录丢失时补空输入，保持下标与 tick 对应
+                        while (game->inputs.size() < tick) {
+                            game->inputs.push_back({events.frames[i], 0});
+                            ++game->missing;
+                        }
+                        game->inputs.push_back({events.frames[i], static_cast<uint8_t>(value & 0xFF)});
+                    }
+                    break;
+                case Event_End:
+                    if (game != nullptr) {
+                        game->ended = true;
+                        game->ticks = static_cast<uint64_t>(value);
+                    }
+                    break;
+                case Event_Checksum:
+                    if (game != nullptr) {
+                        game->checksum = static_cast<uint64_t>(value);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    if (!session.games.empty() && session.games.front().well != 0) {
+        session.multiwell = true;
+    }
+    for (RecordedGame& recorded : session.games) {
+        if (recorded.ended && recorded.inputs.size() < recorded.ticks) {
+            recorded.missing += recorded.ticks - recorded.inputs.size();
+        }
+    }
+    session.has_geometry = std::all_of(geometry_seen, geometry_seen + kGeometryFields, [](bool seen) { return seen; });
+    if (!session.has_geometry && std::any_of(geometry_seen, geometry_seen + kGeometryFields, [](bool seen) { return seen; })) {
+        session.geometry_mismatch = true;
+    }
+    return session.has_geometry && !session.geometry_mismatch && !session.games.empty();
+}
+
+// 与游戏主循环中一个 tick 的顺序一致：施加输入 → GameStep → 碰撞检测
+static void StepTick(GameState& state, const GameGeometry& geo, const GameInput& input, ReplayResult& result) {
+    GameStep(state, geo, input);
+    ++result.ticks;
+    if (GameCollide(state)) {
+        ++result.collisions;
+    }
+}
+
+static void Finish(const GameState& state, ReplayResult& result) {
+    result.score = state.score_m / 5;
+    result.checksum = GameChecksum(state);
+    result.died = state.life < 0;
+}
+
+ReplayResult ReplayGame(const RecordedGame& game, const GameGeometry& geo) {
+    ReplayResult result;
+    GameState state;
+    GameReset(state, geo);
+    GameSeed(state, game.seed);
+
+    for (const TickInput& tick : game.inputs) {
+        GameInput input{(tick.bits & (Input_KeyJump | Input_DecodedJump)) != 0, (tick.bits & Input_Down) != 0};
+        result.key_jumps += (tick.bits & Input_KeyJump) != 0;
+        result.decoded_jumps += (tick.bits & Input_DecodedJump) != 0;
+        StepTick(state, geo, input, result);
+    }
+    Finish(state, result);
+    return result;
+}
+
+Redecoder::Redecoder(const SessionReader& reader, const StimPolicy& policy, int well)
+    : reader_(reader), policy_(policy), decoder_(std::make_unique<SpikeDecoder>()), well_(well) {
+}
+
+bool Redecoder::Configure(const DecoderConfig& config) {
+    loop_.Reset();
+    block_ = 0;
+    offset_ = 0;
+    return decoder_->Configure(config);
+}
+
+bool Redecoder::Feed(uint64_t until) {
+    spikes_.clear();
+    const std::vector<const BlockHeader*>& blocks = reader_.Blocks();
+    while (block_ < blocks.size()) {
+        const BlockHeader* block = blocks[block_];
+        if (block->kind != Block_Spikes || offset_ >= block->count) {
+            ++block_;
+            offset_ = 0;
+            continue;
+        }
+        const SpikeColumns columns = SpikeBlockColumns(block);
+        if (columns.frames[offset_] > until) {
+            break;
+        }
+        if (well_ >= 0 && columns.wells[offset_] != well_) {
+            ++offset_;
+            continue;
+        }
+        maxlab::SpikeEvent spike;
+        spike.frameNo = columns.frames[offset_];
+        spike.channel = columns.channels[offset_];
+        spike.amp = columns.amps[offset_];
+        spike.wellId = columns.wells[offset_];
+        spikes_.push_back(spike);
+        ++offset_;
+    }
+    return loop_.Decode(*decoder_, spikes_.data(), spikes_.size(), until);
+}
+
+// 第 i 个 tick 施加的解码跳跃来自上一 tick 到本 tick 之间到达的 spike；
+// 该段 spike 的空白期由上一 tick 结束后的距离决定
+ReplayResult Redecoder::Run(const RecordedGame& game, const GameGeometry& geo) {
+    ReplayResult result;
+    if (game.inputs.empty()) {
+        return result;
+    }
+    GameState state;
+    GameReset(state, geo);
+    GameSeed(state, game.seed);
+
+    // 开局前的 spike 只滚动窗口，其间解出的跳跃在开局时被丢弃
+    Feed(game.inputs[0].frame > 0 ? game.inputs[0].frame - 1 : 0);
+
+    for (const TickInput& tick : game.inputs) {
+        const bool decoded = Feed(tick.frame);
+        const bool key_jump = (tick.bits & Input_KeyJump) != 0;
+        result.key_jumps += key_jump;
+        result.decoded_jumps += decoded;
+        StepTick(state, geo, GameInput{key_jump || decoded, (tick.bits & Input_Down) != 0}, result);
+        if (state.life < 0) {
+            break;
+        }
+        int sequence;
+        loop_.Evaluate(policy_, calculateDistance(state), tick.frame, 1.0, sequence);
+    }
+    Finish(state, result);
+    return result;
+}
@@ -0,0 +1,77 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ClosedLoopModel.h"
+#include "GameState.h"
+#include "SessionReader.h"
+#include "SpikeDecoder.h"
+
+// 一个 tick 的输入记录
+struct TickInput {
+    uint64_t frame;     // 该 tick 应用输入时的采集帧号
+    uint8_t bits;       // InputBits
+};
+
+struct RecordedGame {
+    uint8_t well = 0;               // 多井会话中所属的井
+    uint64_t seed = 0;
+    std::vector<TickInput> inputs;  // 第 i 项为本局第 i 个 tick
+    uint64_t missing = 0;           // 丢失的输入记录数（记录器队列满），非 0 时无法逐位回放
+    bool ended = false;             // 有 Event_End；程序异常退出时最后一局没有
+    uint64_t ticks = 0;             // Event_End 中的 tick 数
+    uint64_t checksum = 0;          // Event_Checksum
+};
+
+struct RecordedSession {
+    bool has_geometry = false;          // kGeometryFields 项齐全
+    bool geometry_mismatch = false;     // 几何编号越界或缺项：记录来自不同的 GameGeometry，不能逐位回放
+    GameGeometry geometry{};
+    std::vector<RecordedGame> games;    // 按开局顺序，多井时各井的局交错排列
+    bool multiwell = false;             // 游戏事件来自多个井或非 0 井（DINO_WELLS），spike 须按井号分开
+};
+
+// 从会话中取出几何、种子和逐 tick 输入；没有回放记录或几何与当前 GameGeometry 不符时返回 false
+bool LoadRecordedSession(const SessionReader& reader, RecordedSession& session);
+
+struct ReplayResult {
+    uint64_t ticks = 0;
+    uint64_t collisions = 0;
+    uint64_t key_jumps = 0;
+    uint64_t decoded_jumps = 0;
+    unsigned long score = 0;
+    uint64_t checksum = 0;
+    bool died = false;              // life < 0，重新解码时可能早于记录结束
+};
+
+// 按记录的输入逐 tick 回放，结果与原会话逐位一致
+ReplayResult ReplayGame(const RecordedGame& game, const GameGeometry& geo);
+
+// 用新的解码参数重新解码记录的 spike，替换记录中的解码跳跃，键盘输入仍按记录施加。
+// 刺激空白期由策略表按回放中的距离重新推算；spike 来自原会话，不随回放中的刺激变化（开环）。
+// 各局须按顺序调用 Run，spike 游标只前进不后退；多井会话每个井用一个 Redecoder，只取该井的 spike。
+class Redecoder {
+public:
+    Redecoder(const SessionReader& reader, const StimPolicy& policy, int well = -1);   // well < 0 时取全部 spike
+
+    bool Configure(const DecoderConfig& config);
+    ReplayResult Run(const RecordedGame& game, const GameGeometry& geo);
+
+private:
+    bool Feed(uint64_t until);     // 送入帧号不大于 until 的 spike，返回是否解码出跳跃
+
+    const SessionReader& reader_;
+    const StimPolicy& policy_;
+    std::unique_ptr<SpikeDecoder> decoder_;
+    ClosedLoopModel loop_;
+    int well_;
+    size_t block_ = 0;              // spike 游标：当前块和块内位置
+    uint32_t offset_ = 0;
+    std::vector<maxlab::SpikeEvent> spikes_;
+};
+
+#endif
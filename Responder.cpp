@@ -0,0 +1,59 @@
+#include "Responder.h"
+#include <algorithm>
+#include <cmath>
+
+void SimulatedCulture::Configure(const ResponderConfig& config, uint64_t seed) {
+    config_ = config;
+    rng_.seed(seed);
+    pending_.clear();
+    efficacy_ = 1.f;
+    last_stim_ = 0;
+}
+
+void SimulatedCulture::Stimulate(uint64_t frame) {
+    // 距上次刺激越久，效力恢复得越多
+    const float elapsed_ms = (frame - last_stim_) * 1000.f / kFrameRate;
+    efficacy_ = 1.f - (1.f - efficacy_) * std::exp(-elapsed_ms / config_.recovery_ms);
+    last_stim_ = frame;
+
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    if (unit(rng_) < config_.response_prob) {
+        std::poisson_distribution<int> count(config_.evoked_spikes * efficacy_);
+        std::exponential_distribution<float> jitter(1.f / std::max(config_.jitter_ms, 0.001f));
+        std::uniform_int_distribution<int> channel(0, config_.channels - 1);
+        for (int n = count(rng_); n > 0; --n) {
+            const float delay_ms = config_.latency_ms + jitter(rng_);
+            maxlab::SpikeEvent spike;
+            spike.frameNo = frame + static_cast<uint64_t>(delay_ms * kFrameRate / 1000.f);
+            spike.amp = -60.f;
+            spike.channel = static_cast<uint16_t>(channel(rng_));
+            pending_.push_back(spike);
+        }
+    }
+    efficacy_ *= 1.f - config_.adaptation;
+}
+
+void SimulatedCulture::Generate(uint64_t first, uint64_t last, std::vector<maxlab::SpikeEvent>& out) {
+    const size_t begin = out.size();
+
+    const double expected = static_cast<double>(config_.baseline_hz) * config_.channels * (last - first) / kFrameRate;
+    std::poisson_distribution<int> count(expected);
+    std::uniform_int_distribution<uint64_t> frame(first, last - 1);
+    std::uniform_int_distribution<int> channel(0, config_.channels - 1);
+    for (int n = count(rng_); n > 0; --n) {
+        maxlab::SpikeEvent spike;
+        spike.frameNo = frame(rng_);
+        spike.amp = -40.f;
+        spike.channel = static_cast<uint16_t>(channel(rng_));
+        out.push_back(spike);
+    }
+
+    // 到期的诱发 spike 移出待发列表
+    auto due = std::partition(pending_.begin(), pending_.end(),
+                              [last](const maxlab::SpikeEvent& spike) { return spike.frameNo >= last; });
+    out.insert(out.end(), due, pending_.end());
+    pending_.erase(due, pending_.end());
+
+    std::sort(out.begin() + begin, out.end(),
+              [](const maxlab::SpikeEvent& a, const maxlab::SpikeEvent& b) { return a.frameNo < b.frameNo; });
+}
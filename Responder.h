@@ -0,0 +1,42 @@
+#ifndef RESPONDER_H
+#define RESPONDER_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "maxlab/include/maxlab/spike_event.h"
+
+constexpr int kFrameRate = 20000;                   // MaxOne 采样率
+constexpr int kFramesPerTick = kFrameRate / 40;     // 一个游戏 tick 对应的帧数（mFPS = 40）
+
+// 模拟培养皿的响应，供无头扫参使用：自发放电 + 刺激诱发放电，诱发强度随刺激频率适应
+struct ResponderConfig {
+    int channels = 64;              // 模拟 spike 落在 [0, channels) 通道上
+    float baseline_hz = 2.f;        // 每通道自发放电率
+    float evoked_spikes = 12.f;     // 未适应时一次刺激平均诱发的 spike 总数
+    float response_prob = 0.9f;     // 一次刺激引起响应的概率
+    float latency_ms = 8.f;         // 诱发 spike 的最短延迟
+    float jitter_ms = 15.f;         // 在最短延迟之后的指数分布均值
+    float adaptation = 0.3f;        // 每次刺激后效力下降的比例
+    float recovery_ms = 2000.f;     // 效力恢复到 1 的时间常数
+};
+
+class SimulatedCulture {
+public:
+    void Configure(const ResponderConfig& config, uint64_t seed);
+
+    // 在 frame 时刻施加一次刺激，诱发的 spike 排到之后的帧
+    void Stimulate(uint64_t frame);
+
+    // 生成 [first, last) 帧内的全部 spike，按帧号升序追加到 out；须按时间顺序调用
+    void Generate(uint64_t first, uint64_t last, std::vector<maxlab::SpikeEvent>& out);
+
+private:
+    ResponderConfig config_;
+    std::mt19937_64 rng_;
+    std::vector<maxlab::SpikeEvent> pending_;   // 已安排、尚未到达的诱发 spike
+    float efficacy_ = 1.f;
+    uint64_t last_stim_ = 0;
+};
+
+#endif
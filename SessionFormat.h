@@ -0,0 +1,154 @@
+#ifndef SESSION_FORMAT_H
+#define SESSION_FORMAT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 会话段文件（*.dseg）的二进制布局，记录器和离线分析共用
+//
+//   SegmentHeader
+//   BlockHeader + 列数据 + BlockHeader + 列数据 ...
+//
+// spike 块的列依次为 frameNo[u64] channel[u16] amp[f32] wellId[u8]，
+// 事件块的列依次为 frame[u64] value[i64] type[u8] well[u8]，每列按 8 字节对齐
+
+constexpr char kSegmentMagic[8] = {'D', 'I', 'N', 'O', 'S', 'E', 'G', '1'};
+constexpr uint32_t kSegmentVersion = 2;     // 2：事件块增加井号列
+
+struct SegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t index;         // 本会话中的第几个段
+    uint64_t start_ns;      // 会话开始时刻（MonotonicNs）
+    uint64_t used_bytes;    // 含本头部在内的有效字节数，关闭段时写入
+    uint64_t block_count;
+};
+
+enum BlockKind : uint32_t {
+    Block_Spikes = 1,
+    Block_Events = 2,
+};
+
+struct BlockHeader {
+    uint32_t kind;
+    uint32_t count;
+    uint64_t first_frame;
+    uint64_t last_frame;
+    uint64_t bytes;         // 含本头部在内的块长度
+};
+
+// 与 spike 交错记录的游戏事件
+enum GameEventType : uint8_t {
+    Event_Stim = 1,         // value = 序列号，会话内不变，名字见 Event_SequenceName（默认策略 1 = close_loop1, 2 = close_loop2）
+    Event_JumpDecoded = 2,  // value = 当时最近障碍物距离
+    Event_Jump = 3,         // 游戏中恐龙起跳，value = 最近障碍物距离
+    Event_Collision = 4,    // value = 剩余 life
+    Event_Score = 5,        // 一局结束，value = 分数
+    // 以下用于回放，均来自游戏主循环，按写入顺序排列
+    Event_Geometry = 6,     // 会话开始时逐项写出 GameGeometry，value = GeometryField 编号 << 32 | 该项（int）
+    Event_Seed = 7,         // 一局开始，value = 本局随机数种子
+    Event_Input = 8,        // 每个 tick 一条，frame = 当时的采集帧号，value = tick 序号 << 8 | InputBits
+    Event_End = 9,          // 一局结束或会话中止，value = 本局 tick 数
+    Event_Checksum = 10,    // 紧随 Event_End，value = GameChecksum
+    // 以下来自刺激线程，frame 为命令针对的帧（与对应的 Event_Stim 相同）
+    Event_StimDone = 11,    // sendSequence 成功返回，value = 入队到返回的纳秒数
+    Event_StimError = 12,   // sendSequence 失败，value = 序列号
+    // 每次加载刺激策略时来自游戏主循环，每个序列名按 6 字节一片写成若干条，见 PackSequenceName
+    Event_SequenceName = 13,
+};
+
+// Event_Input 的输入位
+enum InputBits : uint8_t {
+    Input_KeyJump = 1,      // 键盘跳跃
+    Input_DecodedJump = 2,  // 解码器跳跃
+    Input_Down = 4,         // 下蹲键按住
+};
+
+// Event_SequenceName 的 value = 序列号 << 56 | 片段序号 << 48 | 名字中该片段的 6 个字节（不足补 0）
+constexpr size_t kSequenceNamePart = 6;
+
+inline int64_t PackSequenceName(int sequence, size_t part, const std::string& name) {
+    uint64_t value = static_cast<uint64_t>(sequence & 0xFF) << 56 | static_cast<uint64_t>(part & 0xFF) << 48;
+    for (size_t i = 0; i < kSequenceNamePart && part * kSequenceNamePart + i < name.size(); ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(name[part * kSequenceNamePart + i])) << (8 * i);
+    }
+    return static_cast<int64_t>(value);
+}
+
+// 按写入顺序逐条调用，names[序列号] 为拼好的名字；片段 0 重新开始一个名字
+inline void UnpackSequenceName(int64_t value, std::vector<std::string>& names) {
+    const uint64_t bits = static_cast<uint64_t>(value);
+    const size_t sequence = bits >> 56;
+    if (names.size() <= sequence) {
+        names.resize(sequence + 1);
+    }
+    std::string& name = names[sequence];
+    if (((bits >> 48) & 0xFF) == 0) {
+        name.clear();
+    }
+    for (size_t i = 0; i < kSequenceNamePart; ++i) {
+        const char c = static_cast<char>(bits >> (8 * i));
+        if (c == '\0') {
+            break;
+        }
+        name.push_back(c);
+    }
+}
+
+inline uint64_t AlignColumn(uint64_t bytes) {
+    return (bytes + 7) & ~uint64_t(7);
+}
+
+inline uint64_t SpikeBlockBytes(uint32_t count) {
+    return sizeof(BlockHeader) + AlignColumn(8ull * count) + AlignColumn(2ull * count) +
+           AlignColumn(4ull * count) + AlignColumn(count);
+}
+
+inline uint64_t EventBlockBytes(uint32_t count) {
+    return sizeof(BlockHeader) + AlignColumn(8ull * count) + AlignColumn(8ull * count) + AlignColumn(count) +
+           AlignColumn(count);
+}
+
+// 读取时按列访问块内数据
+struct SpikeColumns {
+    const uint64_t* frames;
+    const uint16_t* channels;
+    const float* amps;
+    const uint8_t* wells;
+};
+
+struct EventColumns {
+    const uint64_t* frames;
+    const int64_t* values;
+    const uint8_t* types;
+    const uint8_t* wells;   // 事件所属的井号，单井会话全为 0
+};
+
+inline SpikeColumns SpikeBlockColumns(const BlockHeader* block) {
+    const uint8_t* column = reinterpret_cast<const uint8_t*>(block) + sizeof(BlockHeader);
+    SpikeColumns columns;
+    columns.frames = reinterpret_cast<const uint64_t*>(column);
+    column += AlignColumn(8ull * block->count);
+    columns.channels = reinterpret_cast<const uint16_t*>(column);
+    column += AlignColumn(2ull * block->count);
+    columns.amps = reinterpret_cast<const float*>(column);
+    column += AlignColumn(4ull * block->count);
+    columns.wells = column;
+    return columns;
+}
+
+inline EventColumns EventBlockColumns(const BlockHeader* block) {
+    const uint8_t* column = reinterpret_cast<const uint8_t*>(block) + sizeof(BlockHeader);
+    EventColumns columns;
+    columns.frames = reinterpret_cast<const uint64_t*>(column);
+    column += AlignColumn(8ull * block->count);
+    columns.values = reinterpret_cast<const int64_t*>(column);
+    column += AlignColumn(8ull * block->count);
+    columns.types = column;
+    column += AlignColumn(block->count);
+    columns.wells = column;
+    return columns;
+}
+
+#endif
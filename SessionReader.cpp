@@ -0,0 +1,97 @@
+#include "SessionReader.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SessionReader::~SessionReader() {
+    Close();
+}
+
+bool SessionReader::Open(const std::string& dir) {
+    Close();
+    // 段编号连续，遇到第一个不存在的编号即结束
+    for (uint32_t index = 0;; ++index) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/segment_%05u.dseg", dir.c_str(), index);
+        if (access(path, F_OK) != 0) {
+            break;
+        }
+        if (!MapSegment(path)) {
+            Close();
+            return false;
+        }
+    }
+    if (segments_.empty()) {
+        fprintf(stderr, "No segments in %s\n", dir.c_str());
+        return false;
+    }
+    return true;
+}
+
+void SessionReader::Close() {
+    for (const Segment& segment : segments_) {
+        munmap(segment.map, segment.bytes);
+    }
+    segments_.clear();
+    blocks_.clear();
+}
+
+bool SessionReader::MapSegment(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Failed to open segment %s\n", path.c_str());
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SegmentHeader)) {
+        fprintf(stderr, "Segment %s is truncated\n", path.c_str());
+        close(fd);
+        return false;
+    }
+    const size_t bytes = st.st_size;
+    void* map = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Failed to map segment %s\n", path.c_str());
+        return false;
+    }
+    madvise(map, bytes, MADV_SEQUENTIAL);
+    segments_.push_back({map, bytes});
+
+    const uint8_t* base = static_cast<const uint8_t*>(map);
+    const SegmentHeader* header = reinterpret_cast<const SegmentHeader*>(base);
+    if (memcmp(header->magic, kSegmentMagic, sizeof(kSegmentMagic)) != 0) {
+        fprintf(stderr, "Segment %s has a bad header\n", path.c_str());
+        return false;
+    }
+    if (header->version != kSegmentVersion) {
+        fprintf(stderr, "Segment %s has format version %u, this build reads version %u\n", path.c_str(), header->version, kSegmentVersion);
+        return false;
+    }
+    if (segments_.size() == 1) {
+        start_ns_ = header->start_ns;
+    }
+
+    const bool closed = header->used_bytes != 0;
+    const uint64_t end = closed && header->used_bytes <= bytes ? header->used_bytes : bytes;
+    uint64_t offset = sizeof(SegmentHeader);
+    while (offset + sizeof(BlockHeader) <= end) {
+        const BlockHeader* block = reinterpret_cast<const BlockHeader*>(base + offset);
+        const uint64_t expected = block->kind == Block_Spikes   ? SpikeBlockBytes(block->count)
+                                  : block->kind == Block_Events ? EventBlockBytes(block->count)
+                                                                : 0;
+        if (expected == 0 || block->count == 0 || block->bytes != expected || offset + block->bytes > end) {
+            if (closed) {
+                fprintf(stderr, "Segment %s has a bad block at offset %lu\n", path.c_str(), offset);
+                return false;
+            }
+            break;  // 未关闭的段：后面是预分配的空白
+        }
+        blocks_.push_back(block);
+        offset += block->bytes;
+    }
+    return true;
+}
@@ -0,0 +1,39 @@
+#ifndef SESSION_READER_H
+#define SESSION_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SessionFormat.h"
+
+// 只读映射一个会话目录下的全部段文件（segment_00000.dseg ...），按写入顺序列出所有块。
+// 程序异常退出时最后一个段没有写 used_bytes，此时扫描到第一个无效块为止。
+class SessionReader {
+public:
+    SessionReader() = default;
+    SessionReader(const SessionReader&) = delete;
+    SessionReader& operator=(const SessionReader&) = delete;
+    ~SessionReader();
+
+    bool Open(const std::string& dir);
+    void Close();
+
+    const std::vector<const BlockHeader*>& Blocks() const { return blocks_; }
+    size_t Segments() const { return segments_.size(); }
+    uint64_t StartNs() const { return start_ns_; }
+
+private:
+    struct Segment {
+        void* map;
+        size_t bytes;
+    };
+
+    bool MapSegment(const std::string& path);
+
+    std::vector<Segment> segments_;
+    std::vector<const BlockHeader*> blocks_;
+    uint64_t start_ns_ = 0;
+};
+
+#endif
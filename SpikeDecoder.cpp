@@ -0,0 +1,141 @@
+#include "SpikeDecoder.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// 32 字节向量，GCC/Clang 在 SSE2/AVX2/NEON 上都能直接生成 SIMD 指令
+typedef uint16_t u16x16 __attribute__((vector_size(32)));
+
+SpikeDecoder::SpikeDecoder() {
+    DecoderConfig config;
+    Configure(config);
+}
+
+bool SpikeDecoder::Configure(const DecoderConfig& config) {
+    if (config.bin_frames == 0 || config.window_frames < config.bin_frames ||
+        config.window_frames % config.bin_frames != 0 || config.window_frames / config.bin_frames > kMaxBins ||
+        config.window_frames > 65535) {
+        fprintf(stderr, "Invalid decoder window %u / bin %u\n", config.window_frames, config.bin_frames);
+        return false;
+    }
+    if (!ParseChannelList(config.channels, mask_)) {
+        fprintf(stderr, "Invalid decoder channel list %s\n", config.channels ? config.channels : "");
+        return false;
+    }
+    bin_frames_ = config.bin_frames;
+    bin_count_ = config.window_frames / config.bin_frames;
+    threshold_ = config.threshold;
+    Reset();
+    return true;
+}
+
+void SpikeDecoder::Reset() {
+    memset(window_, 0, sizeof(window_));
+    memset(bins_, 0, sizeof(bins_));
+    memset(bin_masked_, 0, sizeof(bin_masked_));
+    masked_total_ = 0;
+    head_ = 0;
+    bin_end_ = 0;
+    started_ = false;
+    above_ = false;
+}
+
+// 向前滚动若干个 bin：把最旧的 bin 从窗口中减掉并清零
+void SpikeDecoder::Roll(uint64_t bins) {
+    if (bins >= bin_count_) {
+        // 只清实际使用的 bin；默认 1 帧窗口时每帧都走这里，清全部 kMaxBins 行要 128 KB
+        memset(window_, 0, sizeof(window_));
+        memset(bins_, 0, sizeof(bins_[0]) * bin_count_);
+        memset(bin_masked_, 0, sizeof(bin_masked_[0]) * bin_count_);
+        masked_total_ = 0;
+        head_ = (head_ + bins) % bin_count_;
+        return;
+    }
+    for (uint64_t b = 0; b < bins; ++b) {
+        head_ = head_ + 1 == bin_count_ ? 0 : head_ + 1;
+        u16x16* window = reinterpret_cast<u16x16*>(window_);
+        u16x16* oldest = reinterpret_cast<u16x16*>(bins_[head_]);
+        for (int i = 0; i < kChannelCount / 16; ++i) {
+            window[i] -= oldest[i];
+            oldest[i] = u16x16{};
+        }
+        masked_total_ -= bin_masked_[head_];
+        bin_masked_[head_] = 0;
+    }
+}
+
+bool SpikeDecoder::Update(uint64_t frame, const maxlab::SpikeEvent* spikes, uint64_t count) {
+    if (!started_) {
+        bin_end_ = frame + bin_frames_;
+        started_ = true;
+    } else if (frame >= bin_end_) {
+        const uint64_t bins = (frame - bin_end_) / bin_frames_ + 1;
+        Roll(bins);
+        bin_end_ += bins * bin_frames_;
+    }
+
+    uint16_t* bin = bins_[head_];
+    uint32_t masked = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        const uint16_t channel = spikes[i].channel & (kChannelCount - 1);
+        ++bin[channel];
+        ++window_[channel];
+        masked += mask_[channel];
+    }
+    bin_masked_[head_] += masked;
+    masked_total_ += masked;
+    const bool above = masked_total_ >= threshold_;
+    const bool rising = above && !above_;
+    above_ = above;
+    return rising;
+}
+
+DecoderConfig DecoderConfigFromEnv() {
+    DecoderConfig config;
+    if (const char* v = getenv("DINO_DECODER_WINDOW")) config.window_frames = strtoul(v, nullptr, 10);
+    if (const char* v = getenv("DINO_DECODER_BIN")) config.bin_frames = strtoul(v, nullptr, 10);
+    if (const char* v = getenv("DINO_DECODER_THRESHOLD")) config.threshold = strtoul(v, nullptr, 10);
+    config.channels = getenv("DINO_DECODER_CHANNELS");
+    return config;
+}
+
+// "0-63,100,200"；空串或 nullptr 选中全部通道
+bool ParseChannelList(const char* list, uint16_t mask[kChannelCount]) {
+    if (list == nullptr || list[0] == '\0') {
+        for (int i = 0; i < kChannelCount; ++i) {
+            mask[i] = 1;
+        }
+        return true;
+    }
+    memset(mask, 0, sizeof(uint16_t) * kChannelCount);
+    const char* p = list;
+    while (*p) {
+        char* end;
+        long first = strtol(p, &end, 10);
+        if (end == p) {
+            return false;
+        }
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            ++p;
+            last = strtol(p, &end, 10);
+            if (end == p) {
+                return false;
+            }
+            p = end;
+        }
+        if (first < 0 || last >= kChannelCount || first > last) {
+            return false;
+        }
+        for (long c = first; c <= last; ++c) {
+            mask[c] = 1;
+        }
+        if (*p == ',') {
+            ++p;
+        } else if (*p != '\0') {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef SPIKE_DECODER_H
+#define SPIKE_DECODER_H
+
+#include <cstdint>
+#include "maxlab/include/maxlab/spike_event.h"
+
+constexpr int kChannelCount = 1024;
+
+struct DecoderConfig {
+    uint32_t window_frames = 1;     // 滑动窗口长度（帧），默认 1 帧即原来的单帧判定
+    uint32_t bin_frames = 1;        // 窗口按 bin 滚动，window_frames 需为其整数倍
+    uint32_t threshold = 10;        // 窗口内选中通道的 spike 总数达到该值时跳跃
+    const char* channels = nullptr; // 选中通道，如 "0-63,100,200"；空表示全部
+};
+
+// 逐通道滑动窗口解码器
+// 每个 spike 只做常数次无分支的加法；bin 滚动时对 1024 个通道做一次向量减法；
+// 判定只比较一个累计值，与本帧 spike 数无关；只在窗口计数从阈值以下升到阈值时判定一次跳跃
+class SpikeDecoder {
+public:
+    static constexpr int kMaxBins = 64;
+
+    SpikeDecoder();
+
+    bool Configure(const DecoderConfig& config);
+    void Reset();
+
+    // 每收到一帧调用一次（含无 spike 的帧），返回本帧是否越过阈值（上升沿）；
+    // 窗口保持在阈值以上时不再重复判定，须先回落到阈值以下
+    bool Update(uint64_t frame, const maxlab::SpikeEvent* spikes, uint64_t count);
+    // 本帧的上升沿没有被采用（刺激后空白期），窗口仍在阈值以上时下一帧再判定一次
+    void Rearm() { above_ = false; }
+
+    uint32_t MaskedTotal() const { return masked_total_; }
+    uint16_t ChannelCount(int channel) const { return window_[channel]; }
+    bool ChannelSelected(int channel) const { return mask_[channel] != 0; }
+
+private:
+    void Roll(uint64_t bins);
+
+    alignas(64) uint16_t window_[kChannelCount];            // 每通道窗口内计数
+    alignas(64) uint16_t mask_[kChannelCount];              // 通道是否选中（0/1）
+    alignas(64) uint16_t bins_[kMaxBins][kChannelCount];    // 环形 bin
+    uint32_t bin_masked_[kMaxBins];                         // 各 bin 中选中通道的 spike 数
+
+    uint32_t masked_total_ = 0;
+    uint32_t bin_frames_ = 1;
+    uint32_t bin_count_ = 1;
+    uint32_t threshold_ = 10;
+    uint32_t head_ = 0;                 // 当前 bin
+    uint64_t bin_end_ = 0;              // 当前 bin 结束帧（不含）
+    bool started_ = false;
+    bool above_ = false;                // 上一帧窗口计数已达到阈值
+};
+
+// DINO_DECODER_WINDOW / DINO_DECODER_BIN（帧）、DINO_DECODER_THRESHOLD、DINO_DECODER_CHANNELS
+DecoderConfig DecoderConfigFromEnv();
+
+bool ParseChannelList(const char* list, uint16_t mask[kChannelCount]);
+
+#endif
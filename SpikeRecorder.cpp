@@ -0,0 +1,246 @@
+#include "SpikeRecorder.h"
+#include "Latency.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SpikeRecorder::~SpikeRecorder() {
+    Stop();
+}
+
+bool SpikeRecorder::Start(const std::string& dir, uint64_t segment_bytes) {
+    if (running_.load()) {
+        return true;
+    }
+    dir_ = dir;
+    segment_bytes_ = segment_bytes;
+    start_ns_ = MonotonicNs();
+    segment_index_ = 0;
+    mkdir(dir_.c_str(), 0755);
+
+    spike_batch_.resize(kBlockRecords);
+    event_batch_.resize(kBlockRecords);
+    if (!OpenSegment()) {
+        return false;
+    }
+    running_ = true;
+    writer_ = std::thread(&SpikeRecorder::WriterLoop, this);
+    return true;
+}
+
+void SpikeRecorder::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    writer_.join();
+    // 写盘线程退出后把剩余数据写完
+    while (DrainOnce()) {
+    }
+    CloseSegment();
+}
+
+void SpikeRecorder::AppendSpikes(const maxlab::SpikeEvent* spikes, uint64_t count) {
+    if (!Enabled()) {
+        return;
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        spikes_.Push(spikes[i]);
+    }
+}
+
+void SpikeRecorder::AppendEvent(RecorderLane lane, GameEventType type, uint64_t frame, int64_t value, uint8_t well) {
+    if (!Enabled()) {
+        return;
+    }
+    events_[lane].Push({frame, value, type, well});
+}
+
+void SpikeRecorder::WriterLoop() {
+    while (running_.load(std::memory_order_acquire)) {
+        if (!DrainOnce()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+// 每条队列取出最多一个块并写入，有数据写出时返回 true
+bool SpikeRecorder::DrainOnce() {
+    if (map_ == nullptr) {
+        return false;
+    }
+    bool wrote = false;
+    for (int lane = 0; lane < RecorderLaneCount; ++lane) {
+        uint32_t n = 0;
+        while (n < kBlockRecords && events_[lane].Pop(event_batch_[n])) {
+            ++n;
+        }
+        if (n > 0) {
+            WriteEventBlock(static_cast<RecorderLane>(lane), n);
+            wrote = true;
+        }
+    }
+
+    uint32_t n = 0;
+    while (n < kBlockRecords && spikes_.Pop(spike_batch_[n])) {
+        ++n;
+    }
+    if (n > 0) {
+        WriteSpikeBlock(n);
+        wrote = true;
+    }
+    return wrote;
+}
+
+bool SpikeRecorder::OpenSegment() {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/segment_%05u.dseg", dir_.c_str(), segment_index_);
+    fd_ = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        fprintf(stderr, "Failed to open segment %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    // 预分配整个段，写入时不再触发文件系统分配
+    if (posix_fallocate(fd_, 0, segment_bytes_) != 0 && ftruncate(fd_, segment_bytes_) != 0) {
+        fprintf(stderr, "Failed to allocate segment %s: %s\n", path, strerror(errno));
+        close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    void* map = mmap(nullptr, segment_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Failed to map segment %s: %s\n", path, strerror(errno));
+        close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    map_ = static_cast<uint8_t*>(map);
+    madvise(map_, segment_bytes_, MADV_SEQUENTIAL);
+
+    SegmentHeader* header = reinterpret_cast<SegmentHeader*>(map_);
+    memcpy(header->magic, kSegmentMagic, sizeof(kSegmentMagic));
+    header->version = kSegmentVersion;
+    header->index = segment_index_;
+    header->start_ns = start_ns_;
+    header->used_bytes = 0;
+    header->block_count = 0;
+    used_ = sizeof(SegmentHeader);
+    blocks_ = 0;
+    return true;
+}
+
+void SpikeRecorder::CloseSegment() {
+    if (map_ == nullptr) {
+        return;
+    }
+    SegmentHeader* header = reinterpret_cast<SegmentHeader*>(map_);
+    header->used_bytes = used_;
+    header->block_count = blocks_;
+    msync(map_, used_, MS_ASYNC);
+    munmap(map_, segment_bytes_);
+    map_ = nullptr;
+    if (ftruncate(fd_, used_) != 0) {
+        fprintf(stderr, "Failed to truncate segment %u\n", segment_index_);
+    }
+    close(fd_);
+    fd_ = -1;
+    ++segment_index_;
+}
+
+// 在当前段中预留 bytes 字节，放不下就换新段
+uint8_t* SpikeRecorder::Reserve(uint64_t bytes) {
+    if (map_ != nullptr && used_ + bytes > segment_bytes_) {
+        CloseSegment();
+        OpenSegment();
+    }
+    if (map_ == nullptr || used_ + bytes > segment_bytes_) {
+        return nullptr;
+    }
+    uint8_t* block = map_ + used_;
+    used_ += bytes;
+    ++blocks_;
+    return block;
+}
+
+void SpikeRecorder::WriteSpikeBlock(uint32_t count) {
+    const uint64_t bytes = SpikeBlockBytes(count);
+    uint8_t* block = Reserve(bytes);
+    if (block == nullptr) {
+        ++lost_blocks_;
+        lost_spikes_ += count;
+        return;
+    }
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(block);
+    header->kind = Block_Spikes;
+    header->count = count;
+    header->first_frame = spike_batch_[0].frameNo;
+    header->last_frame = spike_batch_[count - 1].frameNo;
+    header->bytes = bytes;
+
+    uint8_t* column = block + sizeof(BlockHeader);
+    uint64_t* frames = reinterpret_cast<uint64_t*>(column);
+    column += AlignColumn(8ull * count);
+    uint16_t* channels = reinterpret_cast<uint16_t*>(column);
+    column += AlignColumn(2ull * count);
+    float* amps = reinterpret_cast<float*>(column);
+    column += AlignColumn(4ull * count);
+    uint8_t* wells = column;
+    for (uint32_t i = 0; i < count; ++i) {
+        frames[i] = spike_batch_[i].frameNo;
+        channels[i] = spike_batch_[i].channel;
+        amps[i] = spike_batch_[i].amp;
+        wells[i] = spike_batch_[i].wellId;
+    }
+    written_spikes_ += count;
+}
+
+void SpikeRecorder::WriteEventBlock(RecorderLane lane, uint32_t count) {
+    const uint64_t bytes = EventBlockBytes(count);
+    uint8_t* block = Reserve(bytes);
+    if (block == nullptr) {
+        ++lost_blocks_;
+        lost_events_[lane] += count;
+        return;
+    }
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(block);
+    header->kind = Block_Events;
+    header->count = count;
+    header->first_frame = event_batch_[0].frame;
+    header->last_frame = event_batch_[count - 1].frame;
+    header->bytes = bytes;
+
+    uint8_t* column = block + sizeof(BlockHeader);
+    uint64_t* frames = reinterpret_cast<uint64_t*>(column);
+    column += AlignColumn(8ull * count);
+    int64_t* values = reinterpret_cast<int64_t*>(column);
+    column += AlignColumn(8ull * count);
+    uint8_t* types = column;
+    column += AlignColumn(count);
+    uint8_t* wells = column;
+    for (uint32_t i = 0; i < count; ++i) {
+        frames[i] = event_batch_[i].frame;
+        values[i] = event_batch_[i].value;
+        types[i] = event_batch_[i].type;
+        wells[i] = event_batch_[i].well;
+    }
+    written_events_ += count;
+}
+
+void SpikeRecorder::Print(FILE* out) const {
+    static const char* const kLaneNames[RecorderLaneCount] = {"acquisition", "game", "stim"};
+    fprintf(out, "recorder: spikes=%lu events=%lu segments=%u dropped_spikes=%lu lost_blocks=%lu lost_spikes=%lu\n",
+            written_spikes_, written_events_, segment_index_, DroppedSpikes(), lost_blocks_, lost_spikes_);
+    for (int lane = 0; lane < RecorderLaneCount; ++lane) {
+        const uint64_t dropped = events_[lane].Dropped();
+        if (dropped > 0 || lost_events_[lane] > 0) {
+            fprintf(out, "recorder %s events: dropped=%lu lost=%lu\n", kLaneNames[lane], dropped, lost_events_[lane]);
+        }
+    }
+    // 种子、几何、输入和校验和都在游戏事件中，少一条回放就对不上
+    if (events_[Lane_Game].Dropped() > 0 || lost_events_[Lane_Game] > 0) {
+        fprintf(out, "recorder: game events missing, session may not replay\n");
+    }
+}
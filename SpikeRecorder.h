@@ -0,0 +1,92 @@
+#ifndef SPIKE_RECORDER_H
+#define SPIKE_RECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SpscRing.h"
+#include "SessionFormat.h"
+#include "maxlab/include/maxlab/spike_event.h"
+
+// 事件来源，每个来源一个单生产者队列
+enum RecorderLane {
+    Lane_Acquisition = 0,   // message_thread
+    Lane_Game = 1,          // 游戏主循环
+    Lane_Stim = 2,          // 刺激线程
+    RecorderLaneCount,
+};
+
+struct RecordedEvent {
+    uint64_t frame;
+    int64_t value;
+    GameEventType type;
+    uint8_t well;
+};
+
+// 会话记录器：采集线程只把 spike 拷进无锁队列，写盘线程把它们按列写入预分配、
+// 内存映射的段文件，满了就换下一个段。队列满时丢弃并计数，绝不阻塞采集线程。
+class SpikeRecorder {
+public:
+    ~SpikeRecorder();
+
+    bool Start(const std::string& dir, uint64_t segment_bytes);
+    void Stop();
+    bool Enabled() const { return running_.load(std::memory_order_relaxed); }
+
+    void AppendSpikes(const maxlab::SpikeEvent* spikes, uint64_t count);
+    void AppendEvent(RecorderLane lane, GameEventType type, uint64_t frame, int64_t value, uint8_t well = 0);
+
+    // 队列满时丢弃的记录
+    uint64_t DroppedSpikes() const { return spikes_.Dropped(); }
+    uint64_t DroppedEvents(RecorderLane lane) const { return events_[lane].Dropped(); }
+    // 段文件打不开或放不下时整块丢失的记录，只由写盘线程累计，Stop 之后读取
+    uint64_t LostBlocks() const { return lost_blocks_; }
+    uint64_t LostSpikes() const { return lost_spikes_; }
+    uint64_t LostEvents(RecorderLane lane) const { return lost_events_[lane]; }
+    uint64_t WrittenSpikes() const { return written_spikes_; }
+    uint64_t WrittenEvents() const { return written_events_; }
+    uint32_t Segments() const { return segment_index_; }
+
+    // 会话结束时的汇总；游戏事件有丢失时提示会话可能无法回放
+    void Print(FILE* out) const;
+
+private:
+    static constexpr uint32_t kBlockRecords = 4096;
+
+    void WriterLoop();
+    bool DrainOnce();
+    bool OpenSegment();
+    void CloseSegment();
+    uint8_t* Reserve(uint64_t bytes);
+    void WriteSpikeBlock(uint32_t count);
+    void WriteEventBlock(RecorderLane lane, uint32_t count);
+
+    SpscRing<maxlab::SpikeEvent, 1 << 20> spikes_;
+    SpscRing<RecordedEvent, 1 << 14> events_[RecorderLaneCount];
+
+    std::atomic<bool> running_{false};
+    std::thread writer_;
+    std::string dir_;
+    uint64_t segment_bytes_ = 0;
+    uint64_t start_ns_ = 0;
+
+    // 当前段，只由写盘线程访问
+    int fd_ = -1;
+    uint8_t* map_ = nullptr;
+    uint64_t used_ = 0;
+    uint64_t blocks_ = 0;
+    uint32_t segment_index_ = 0;
+
+    std::vector<maxlab::SpikeEvent> spike_batch_;
+    std::vector<RecordedEvent> event_batch_;
+    uint64_t written_spikes_ = 0;
+    uint64_t written_events_ = 0;
+    uint64_t lost_blocks_ = 0;
+    uint64_t lost_spikes_ = 0;
+    uint64_t lost_events_[RecorderLaneCount] = {};
+};
+
+#endif
@@ -0,0 +1,132 @@
+#include "SpriteAtlas.h"
+#include <algorithm>
+#include <iostream>
+
+SpriteAtlas::~SpriteAtlas() {
+    Destroy();
+}
+
+void SpriteAtlas::Destroy() {
+    if (texture_) {
+        SDL_DestroyTexture(texture_);
+        texture_ = nullptr;
+    }
+    for (Sprite& sprite : sprites_) {
+        if (sprite.owned && sprite.surface) {
+            SDL_FreeSurface(sprite.surface);
+        }
+    }
+    sprites_.clear();
+}
+
+int SpriteAtlas::Add(SDL_Surface* surface, bool owned) {
+    sprites_.push_back(Sprite{surface, owned, SDL_Rect{0, 0, 0, 0}});
+    return static_cast<int>(sprites_.size()) - 1;
+}
+
+bool SpriteAtlas::Build(SDL_Renderer* renderer) {
+    // 按高度从高到低分行排列（shelf packing），贴图之间留 1 像素避免采样串色
+    constexpr int kPad = 1;
+    std::vector<int> order(sprites_.size());
+    int widest = 0;
+    for (size_t i = 0; i < sprites_.size(); ++i) {
+        order[i] = static_cast<int>(i);
+        if (sprites_[i].surface) {
+            widest = std::max(widest, sprites_[i].surface->w);
+        }
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        const int ha = sprites_[a].surface ? sprites_[a].surface->h : 0;
+        const int hb = sprites_[b].surface ? sprites_[b].surface->h : 0;
+        return ha > hb;
+    });
+
+    width_ = 1024;
+    while (width_ < widest + kPad) {
+        width_ *= 2;
+    }
+    int x = 0, y = 0, shelf = 0;
+    for (int i : order) {
+        SDL_Surface* surface = sprites_[i].surface;
+        if (surface == nullptr) {
+            continue;
+        }
+        if (x + surface->w > width_) {
+            x = 0;
+            y += shelf + kPad;
+            shelf = 0;
+        }
+        sprites_[i].rect = SDL_Rect{x, y, surface->w, surface->h};
+        x += surface->w + kPad;
+        shelf = std::max(shelf, surface->h);
+    }
+    height_ = y + shelf;
+
+    SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, width_, std::max(height_, 1), 32, SDL_PIXELFORMAT_RGBA32);
+    if (atlas == nullptr) {
+        std::cerr << "Failed to create sprite atlas: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    for (Sprite& sprite : sprites_) {
+        if (sprite.surface) {
+            SDL_SetSurfaceBlendMode(sprite.surface, SDL_BLENDMODE_NONE);
+            SDL_Rect dst = sprite.rect;
+            SDL_BlitSurface(sprite.surface, nullptr, atlas, &dst);
+        }
+        if (sprite.owned && sprite.surface) {
+            SDL_FreeSurface(sprite.surface);
+        }
+        sprite.surface = nullptr;
+        sprite.owned = false;
+    }
+    texture_ = SDL_CreateTextureFromSurface(renderer, atlas);
+    SDL_FreeSurface(atlas);
+    if (texture_ == nullptr) {
+        std::cerr << "Failed to upload sprite atlas: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(texture_, SDL_BLENDMODE_BLEND);
+    std::cout << "sprite atlas: " << sprites_.size() << " sprites, " << width_ << "x" << height_ << std::endl;
+    return true;
+}
+
+SpriteBatch::SpriteBatch(const SpriteAtlas& atlas) : atlas_(atlas) {
+    vertices_.reserve(256 * 4);
+    indices_.reserve(256 * 6);
+}
+
+void SpriteBatch::Begin() {
+    vertices_.clear();
+    indices_.clear();
+}
+
+void SpriteBatch::Add(int sprite, const SDL_Rect* src, const SDL_Rect& dst) {
+    const SDL_Rect& rect = atlas_.Rect(sprite);
+    const SDL_Rect part = src ? SDL_Rect{rect.x + src->x, rect.y + src->y, src->w, src->h} : rect;
+    if (part.w <= 0 || part.h <= 0 || dst.w <= 0 || dst.h <= 0) {
+        return;
+    }
+
+    const float iw = 1.f / atlas_.Width(), ih = 1.f / atlas_.Height();
+    const float u0 = part.x * iw, v0 = part.y * ih, u1 = (part.x + part.w) * iw, v1 = (part.y + part.h) * ih;
+    const float x0 = static_cast<float>(dst.x), y0 = static_cast<float>(dst.y);
+    const float x1 = static_cast<float>(dst.x + dst.w), y1 = static_cast<float>(dst.y + dst.h);
+    const SDL_Color white{255, 255, 255, 255};
+
+    const int base = static_cast<int>(vertices_.size());
+    vertices_.push_back(SDL_Vertex{{x0, y0}, white, {u0, v0}});
+    vertices_.push_back(SDL_Vertex{{x1, y0}, white, {u1, v0}});
+    vertices_.push_back(SDL_Vertex{{x1, y1}, white, {u1, v1}});
+    vertices_.push_back(SDL_Vertex{{x0, y1}, white, {u0, v1}});
+    const int quad[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+    indices_.insert(indices_.end(), quad, quad + 6);
+}
+
+void SpriteBatch::Flush(SDL_Renderer* renderer) {
+    if (!vertices_.empty() && atlas_.Texture()) {
+        SDL_RenderGeometry(renderer, atlas_.Texture(), vertices_.data(), static_cast<int>(vertices_.size()),
+                           indices_.data(), static_cast<int>(indices_.size()));
+        ++submits_;
+    }
+    Begin();
+}
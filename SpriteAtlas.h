@@ -0,0 +1,60 @@
+#ifndef SPRITE_ATLAS_H
+#define SPRITE_ATLAS_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+// 启动时把所有贴图拼进一张纹理；Add 只登记，Build 时一次性排版、拷贝像素、上传
+class SpriteAtlas {
+public:
+    SpriteAtlas() = default;
+    ~SpriteAtlas();
+    SpriteAtlas(const SpriteAtlas&) = delete;
+    SpriteAtlas& operator=(const SpriteAtlas&) = delete;
+
+    // 返回贴图编号，按登记顺序从 0 开始；owned 为 true 时 Build 后由图集释放 surface
+    int Add(SDL_Surface* surface, bool owned = false);
+    bool Build(SDL_Renderer* renderer);
+    void Destroy();
+
+    SDL_Texture* Texture() const { return texture_; }
+    const SDL_Rect& Rect(int sprite) const { return sprites_[sprite].rect; }   // 在图集中的位置
+    int Width() const { return width_; }
+    int Height() const { return height_; }
+    int Count() const { return static_cast<int>(sprites_.size()); }
+
+private:
+    struct Sprite {
+        SDL_Surface* surface;
+        bool owned;
+        SDL_Rect rect;
+    };
+
+    std::vector<Sprite> sprites_;
+    SDL_Texture* texture_ = nullptr;
+    int width_ = 0;
+    int height_ = 0;
+};
+
+// 一帧内所有贴图拷贝攒成三角形，Flush 时用一次 SDL_RenderGeometry 提交
+class SpriteBatch {
+public:
+    explicit SpriteBatch(const SpriteAtlas& atlas);
+
+    void Begin();
+    // 语义同 SDL_RenderCopy：src 为贴图内的子矩形（nullptr 为整张），宽或高为 0 时不画
+    void Add(int sprite, const SDL_Rect* src, const SDL_Rect& dst);
+    void Flush(SDL_Renderer* renderer);
+
+    int Quads() const { return static_cast<int>(vertices_.size() / 4); }
+    uint64_t Submits() const { return submits_; }
+
+private:
+    const SpriteAtlas& atlas_;
+    std::vector<SDL_Vertex> vertices_;
+    std::vector<int> indices_;
+    uint64_t submits_ = 0;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 单生产者/单消费者有界无锁环形队列
+// 生产者只写 head_，消费者只写 tail_，两者分占不同缓存行避免伪共享
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing 容量必须是2的幂");
+
+public:
+    // 生产者调用；队列满时返回 false 并计入 dropped
+    bool Push(const T& item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - cachedTail_ == N) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head - cachedTail_ == N) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        buffer_[head & (N - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者调用；队列空时返回 false
+    bool Pop(T& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == cachedHead_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail == cachedHead_) {
+                return false;
+            }
+        }
+        item = buffer_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似长度，任一线程均可调用
+    size_t Size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    uint64_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    static constexpr size_t Capacity() { return N; }
+
+private:
+    alignas(64) std::atomic<size_t> head_{0};   // 生产者写位置
+    size_t cachedTail_ = 0;                     // 生产者缓存的读位置
+    std::atomic<uint64_t> dropped_{0};
+    alignas(64) std::atomic<size_t> tail_{0};   // 消费者读位置
+    size_t cachedHead_ = 0;                     // 消费者缓存的写位置
+    alignas(64) T buffer_[N];
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "StimDispatcher.h"
+#include <cstdint>
+#include <cstdio>
+#include "maxlab/include/maxlab/errors.h"
+#include "maxlab/include/maxlab/api_comm.h"
+#include "Globals.h"
+#include "Trace.h"
+
+static uint64_t OutstandingKey(uint64_t id, int sequence) {
+    return id << 16 | static_cast<uint16_t>(sequence + 1);
+}
+
+StimDispatcher::~StimDispatcher() {
+    Stop();
+}
+
+void StimDispatcher::Start(const ThreadPolicy& policy) {
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread(&StimDispatcher::Run, this, policy);
+}
+
+void StimDispatcher::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    posted_.fetch_add(1, std::memory_order_release);
+    posted_.notify_one();
+    thread_.join();
+    StimCommand command;
+    while (queue_.Pop(command)) {
+        discarded_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+StimSubmit StimDispatcher::Submit(StimCommand& command) {
+    std::atomic<uint64_t>& outstanding = outstanding_[command.slot];
+    const uint64_t previous = outstanding.load(std::memory_order_acquire);
+    if (previous != 0 && (previous & 0xffff) == OutstandingKey(0, command.sequence)) {
+        ++merged_;
+        return StimSubmit::Merged;
+    }
+    command.id = next_id_++;
+    command.enqueue_ns = MonotonicNs();
+    const uint64_t key = OutstandingKey(command.id, command.sequence);
+    outstanding.store(key, std::memory_order_release);
+    if (!queue_.Push(command)) {
+        uint64_t expected = key;
+        outstanding.compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+        return StimSubmit::Dropped;
+    }
+    // 刺激线程正在等待时才有唤醒的系统调用
+    posted_.fetch_add(1, std::memory_order_release);
+    posted_.notify_one();
+    return StimSubmit::Queued;
+}
+
+void StimDispatcher::Run(ThreadPolicy policy) {
+    // 线程绑核与实时优先级：DINO_STIM_CPU / DINO_STIM_FIFO
+    ApplyThreadPolicy("stimulation", policy);
+    StimCommand command;
+    while (running_.load(std::memory_order_acquire)) {
+        const uint32_t seen = posted_.load(std::memory_order_acquire);
+        while (running_.load(std::memory_order_relaxed) && queue_.Pop(command)) {
+            Send(command);
+        }
+        posted_.wait(seen, std::memory_order_acquire);
+    }
+}
+
+void StimDispatcher::Send(const StimCommand& command) {
+    const uint64_t start_ns = MonotonicNs();
+    const maxlab::Status status = maxlab::sendSequence(command.name);
+    const uint64_t done_ns = MonotonicNs();
+    const uint8_t well = well_layout.ids[command.slot];
+
+    // 完成后才允许同一序列再次入队
+    uint64_t expected = OutstandingKey(command.id, command.sequence);
+    outstanding_[command.slot].compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+
+    latency.Record(Stage_Queue_Stim, command.enqueue_ns, start_ns);
+    latency.Record(Stage_Recv_Stim, command.recv_ns, done_ns);
+    if (command.cross_ns != 0) {
+        latency.Record(Stage_Cross_Stim, command.cross_ns, done_ns);
+    }
+
+    StimMetrics& stim_metrics = metrics.Data().stim;
+    metrics.CountStim(command.name);
+    Bump(metrics.Data().well[command.slot].stims);
+    Bump(stim_metrics.queue_ns, start_ns - command.enqueue_ns);
+    Bump(stim_metrics.send_ns, done_ns - start_ns);
+    if (done_ns - start_ns > stim_metrics.send_max_ns.load(std::memory_order_relaxed)) {
+        Gauge(stim_metrics.send_max_ns, done_ns - start_ns);
+    }
+
+    if (status == maxlab::Status::MAXLAB_OK) {
+        sent_.fetch_add(1, std::memory_order_relaxed);
+        recorder.AppendEvent(Lane_Stim, Event_StimDone, command.frame, done_ns - command.enqueue_ns, well);
+        return;
+    }
+    failed_.fetch_add(1, std::memory_order_relaxed);
+    Bump(stim_metrics.errors);
+    TRACE(Trace_Info, Trace_StimError, status, command.frame);
+    recorder.AppendEvent(Lane_Stim, Event_StimError, command.frame, command.sequence, well);
+    maxlab::Response response = maxlab::sendRaw("get_errors");
+    fprintf(stderr, "An error occured: %s (%s, frame %lu)\n", response.content, command.name, command.frame);
+    maxlab::freeResponse(&response);
+}
@@ -0,0 +1,67 @@
+#ifndef STIM_DISPATCHER_H
+#define STIM_DISPATCHER_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "SpscRing.h"
+#include "ThreadTuning.h"
+#include "Wells.h"
+
+// 采集线程 -> 刺激线程的一条刺激命令
+struct StimCommand {
+    uint64_t frame;         // 命令针对的放大器帧号
+    uint64_t recv_ns;       // 收到该帧的时刻
+    uint64_t cross_ns;      // 障碍物越过 200 px 的时刻，与这次刺激无关时为 0
+    uint64_t enqueue_ns;
+    uint64_t id;            // 提交序号，从 1 开始
+    int16_t sequence;       // 策略中的序列号
+    uint8_t slot;
+    char name[45];          // 发送的序列名，多井时已带井号
+};
+
+enum class StimSubmit : uint8_t {
+    Queued,
+    Merged,     // 同一路同一序列还在队列中或正在发送，不再重复发送
+    Dropped,    // 队列满
+};
+
+// 刺激线程：sendSequence 是一次到 mxwserver 的往返，失败时还要 get_errors，都不放在采集线程上。
+// 采集线程只把命令放进无锁队列，刺激线程按顺序发送，并为每条命令留下完成记录
+// （会话文件中的 Event_StimDone / Event_StimError、延迟直方图和看板计数）
+class StimDispatcher {
+public:
+    ~StimDispatcher();
+
+    void Start(const ThreadPolicy& policy);
+    void Stop();            // 未发出的命令丢弃并计数
+
+    // 采集线程调用，不阻塞
+    StimSubmit Submit(StimCommand& command);
+
+    uint64_t Sent() const { return sent_.load(std::memory_order_relaxed); }
+    uint64_t Failed() const { return failed_.load(std::memory_order_relaxed); }
+    uint64_t Merged() const { return merged_; }
+    uint64_t Dropped() const { return queue_.Dropped(); }
+    uint64_t Discarded() const { return discarded_.load(std::memory_order_relaxed); }
+
+private:
+    void Run(ThreadPolicy policy);
+    void Send(const StimCommand& command);
+
+    SpscRing<StimCommand, 256> queue_;
+    std::atomic<uint32_t> posted_{0};   // 每次入队加一，刺激线程在上面等待
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    // 每路最近一条未完成命令：id << 16 | (sequence + 1)，完成后由刺激线程清零
+    std::atomic<uint64_t> outstanding_[kMaxWells] = {};
+    uint64_t next_id_ = 1;      // 只由采集线程访问
+    uint64_t merged_ = 0;       // 只由采集线程访问
+
+    std::atomic<uint64_t> sent_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::atomic<uint64_t> discarded_{0};
+};
+
+#endif
@@ -0,0 +1,181 @@
+#include "StimPolicy.h"
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+// 与 set_sti_parameter/stim_policy.cfg 一致，找不到配置文件时使用
+static const char* kDefaultPolicy =
+    "band 1500 max  close_loop1 40000\n"
+    "band 200  1500 close_loop1 20*d\n"
+    "band 120  200  close_loop1 2400\n"
+    "band 80   120  close_loop2 -     once\n"
+    "immediate 194 200\n";
+
+// "max" 表示无上限
+static bool ParseBound(const std::string& word, int& value) {
+    if (word == "max") {
+        value = StimPolicy::kMaxDistance + 1;
+        return true;
+    }
+    char* end;
+    const long v = strtol(word.c_str(), &end, 10);
+    if (word.empty() || *end != '\0' || v < -1 || v > StimPolicy::kMaxDistance) {
+        return false;
+    }
+    value = static_cast<int>(v);
+    return true;
+}
+
+// "40000" / "20*d" / "-"
+static bool ParseIsi(const std::string& word, PolicyEntry& entry) {
+    if (word == "-") {
+        entry.isi_mode = Isi_None;
+        entry.isi = 0;
+        return true;
+    }
+    char* end;
+    const unsigned long v = strtoul(word.c_str(), &end, 10);
+    if (end == word.c_str()) {
+        return false;
+    }
+    if (*end == '\0') {
+        entry.isi_mode = Isi_Fixed;
+    } else if (strcmp(end, "*d") == 0) {
+        entry.isi_mode = Isi_Distance;
+    } else {
+        return false;
+    }
+    entry.isi = static_cast<uint32_t>(v);
+    return true;
+}
+
+std::unique_ptr<StimPolicy> StimPolicy::Parse(const std::string& text, std::string& error, const StimPolicy* previous) {
+    std::unique_ptr<StimPolicy> policy(new StimPolicy());
+    if (previous != nullptr) {
+        policy->sequences_ = previous->sequences_;
+    }
+    std::istringstream in(text);
+    std::string line;
+    int line_no = 0;
+    int bands = 0;
+    char message[128];
+
+    while (std::getline(in, line)) {
+        ++line_no;
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) {
+            line.erase(hash);
+        }
+        std::istringstream words(line);
+        std::string keyword;
+        if (!(words >> keyword)) {
+            continue;
+        }
+
+        std::string lo_word, hi_word;
+        int lo, hi;
+        if (!(words >> lo_word >> hi_word) || !ParseBound(lo_word, lo) || !ParseBound(hi_word, hi) || lo >= hi) {
+            snprintf(message, sizeof(message), "line %d: invalid range", line_no);
+            error = message;
+            return nullptr;
+        }
+
+        if (keyword == "immediate") {
+            for (int d = lo + 1; d <= hi; ++d) {
+                policy->table_[d].immediate = true;
+            }
+            continue;
+        }
+        if (keyword != "band") {
+            snprintf(message, sizeof(message), "line %d: unknown keyword %s", line_no, keyword.c_str());
+            error = message;
+            return nullptr;
+        }
+
+        PolicyEntry entry;
+        std::string sequence, isi, option;
+        if (!(words >> sequence >> isi) || !ParseIsi(isi, entry)) {
+            snprintf(message, sizeof(message), "line %d: missing sequence name or invalid isi", line_no);
+            error = message;
+            return nullptr;
+        }
+        while (words >> option) {
+            if (option != "once") {
+                snprintf(message, sizeof(message), "line %d: unknown option %s", line_no, option.c_str());
+                error = message;
+                return nullptr;
+            }
+            entry.once = true;
+        }
+
+        // 序列编号按首次出现顺序分配，已有的编号不变
+        size_t index = 0;
+        while (index < policy->sequences_.size() && policy->sequences_[index] != sequence) {
+            ++index;
+        }
+        if (index == policy->sequences_.size()) {
+            policy->sequences_.push_back(sequence);
+        }
+        entry.sequence = static_cast<int16_t>(index + 1);
+        entry.band = static_cast<int16_t>(bands++);
+
+        for (int d = lo + 1; d <= hi; ++d) {
+            const bool immediate = policy->table_[d].immediate;
+            if (policy->table_[d].band >= 0) {
+                snprintf(message, sizeof(message), "line %d: range overlaps an earlier band", line_no);
+                error = message;
+                return nullptr;
+            }
+            policy->table_[d] = entry;
+            policy->table_[d].immediate = immediate;
+        }
+    }
+    return policy;
+}
+
+bool StimPolicyStore::Reload(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    struct stat st;
+    const bool exists = stat(path.c_str(), &st) == 0;
+    // 修改时间精确到纳秒，再比较大小，同一秒内的两次保存也能区分
+    if (Current() != nullptr && (!exists || (st.st_mtim.tv_sec == mtime_.tv_sec &&
+                                             st.st_mtim.tv_nsec == mtime_.tv_nsec && st.st_size == size_))) {
+        return false;
+    }
+
+    std::string text = kDefaultPolicy;
+    const char* source = "built-in default";
+    if (exists) {
+        std::ifstream file(path);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        text = buffer.str();
+        source = path.c_str();
+    }
+
+    std::string error;
+    std::unique_ptr<StimPolicy> policy = StimPolicy::Parse(text, error, Current());
+    if (exists) {
+        mtime_ = st.st_mtim;
+        size_ = st.st_size;
+    }
+    if (!policy) {
+        // 配置写错时保留当前策略，首次加载则退回默认
+        fprintf(stderr, "Failed to parse stim policy %s: %s\n", source, error.c_str());
+        if (Current() != nullptr) {
+            return false;
+        }
+        policy = StimPolicy::Parse(kDefaultPolicy, error);
+        source = "built-in default";
+    }
+
+    printf("stim policy: %s, %d sequences\n", source, policy->SequenceCount());
+    current_.store(policy.get(), std::memory_order_release);
+    versions_.push_back(std::move(policy));
+    return true;
+}
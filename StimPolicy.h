@@ -0,0 +1,74 @@
+#ifndef STIM_POLICY_H
+#define STIM_POLICY_H
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "GameState.h"
+
+// 距离 -> 刺激策略，由配置文件编译成按距离下标的稠密表，每帧查表 O(1)
+struct PolicyEntry {
+    int16_t band = -1;          // 所在区间编号，-1 表示不刺激
+    int16_t sequence = 0;       // 序列编号，从 1 开始，对应 StimPolicy::SequenceName；重新加载后不变
+    uint8_t isi_mode = 0;       // IsiMode
+    bool once = false;
+    bool immediate = false;     // 进入该距离时立即刺激
+    uint32_t isi = 0;           // 固定帧数或距离倍数
+};
+
+enum IsiMode : uint8_t {
+    Isi_None = 0,       // 不安排下次评估
+    Isi_Fixed = 1,      // 固定帧数
+    Isi_Distance = 2,   // isi × 距离
+};
+
+class StimPolicy {
+public:
+    static constexpr int kMaxDistance = 2 * Width_Window;   // 超过该值（含 INT_MAX）都落在最后一格
+
+    // 解析失败时返回 nullptr，并在 error 中给出行号。
+    // previous 不为空时沿用它的序列编号，新出现的序列名接在后面，同一编号始终对应同一序列
+    static std::unique_ptr<StimPolicy> Parse(const std::string& text, std::string& error,
+                                             const StimPolicy* previous = nullptr);
+
+    const PolicyEntry& Lookup(int distance) const {
+        const int index = distance < 0 ? 0 : (distance > kMaxDistance ? kMaxDistance + 1 : distance);
+        return table_[index];
+    }
+
+    uint64_t IsiFrames(const PolicyEntry& entry, int distance) const {
+        return entry.isi_mode == Isi_Distance ? static_cast<uint64_t>(distance) * entry.isi : entry.isi;
+    }
+
+    const char* SequenceName(int sequence) const { return sequences_[sequence - 1].c_str(); }
+    int SequenceCount() const { return static_cast<int>(sequences_.size()); }
+
+private:
+    PolicyEntry table_[kMaxDistance + 2];
+    std::vector<std::string> sequences_;
+};
+
+// 持有已加载的策略；采集线程每帧无锁读取当前版本。
+// 旧版本保留到进程结束，采集线程手里的指针始终有效（重新加载只发生在开局，次数很少）。
+class StimPolicyStore {
+public:
+    const StimPolicy* Current() const { return current_.load(std::memory_order_acquire); }
+
+    // 文件修改时间或大小变化时重新加载，返回是否切换了策略；文件缺失时使用内置默认策略。
+    // 新版本沿用旧版本的序列编号，会话记录和在线 PSTH 中的序列号在整个会话内不变
+    bool Reload(const std::string& path);
+
+private:
+    std::atomic<const StimPolicy*> current_{nullptr};
+    std::vector<std::unique_ptr<StimPolicy>> versions_;
+    std::mutex mutex_;
+    timespec mtime_ = {};
+    int64_t size_ = -1;
+};
+
+#endif
@@ -0,0 +1,215 @@
+#include "StimResponse.h"
+#include <algorithm>
+#include <cstdlib>
+
+static constexpr double kFramesPerSecond = 20000.0;
+
+bool StimResponse::Configure(const StimResponseConfig& config) {
+    if (config.bin_frames == 0 || config.post_bins == 0 || config.recent_weight <= 0 || config.recent_weight > 1) {
+        fprintf(stderr, "Invalid PSTH config: bin=%u frames, post=%u bins\n", config.bin_frames, config.post_bins);
+        return false;
+    }
+    config_ = config;
+    bins_ = config.pre_bins + config.post_bins;
+    // 环中须同时容纳一次刺激的前后窗口和正在累计的当前 bin
+    uint64_t ring_bins = 2;
+    while (ring_bins < bins_ + 1) {
+        ring_bins *= 2;
+    }
+    ring_mask_ = ring_bins - 1;
+    ring_.assign(ring_bins * kChannelCount, 0);
+    psth_ = std::vector<std::atomic<uint32_t>>(static_cast<size_t>(kResponseSequences) * bins_ * kChannelCount);
+    for (int s = 0; s < kResponseSequences; ++s) {
+        trials_done_[s].store(0, std::memory_order_relaxed);
+        pre_spikes_[s].store(0, std::memory_order_relaxed);
+        post_spikes_[s].store(0, std::memory_order_relaxed);
+        recent_pre_hz_[s].store(0, std::memory_order_relaxed);
+        recent_post_hz_[s].store(0, std::memory_order_relaxed);
+    }
+    dropped_trials_.store(0, std::memory_order_relaxed);
+    started_ = false;
+    trial_head_ = 0;
+    trial_count_ = 0;
+    return true;
+}
+
+int StimResponse::Advance(uint64_t frame_no) {
+    if (ring_.empty()) {
+        return 0;
+    }
+    const uint64_t bin = frame_no / config_.bin_frames;
+    if (!started_) {
+        started_ = true;
+        first_bin_ = bin;
+        current_bin_ = bin;
+        return 0;
+    }
+    int folded = 0;
+    while (current_bin_ < bin) {
+        // 长时间没有帧且没有未结束的刺激时直接清空整个环
+        if (trial_count_ == 0 && bin - current_bin_ > ring_mask_) {
+            std::fill(ring_.begin(), ring_.end(), 0);
+            current_bin_ = bin;
+            break;
+        }
+        ++current_bin_;
+        // 刺激后窗口的最后一个 bin 已经结束，先累加再覆盖它最早的 bin
+        while (trial_count_ > 0 && trials_[trial_head_].bin + config_.post_bins <= current_bin_) {
+            Fold(trials_[trial_head_]);
+            trial_head_ = (trial_head_ + 1) % kResponseTrials;
+            --trial_count_;
+            ++folded;
+        }
+        std::fill_n(ring_.begin() + (current_bin_ & ring_mask_) * kChannelCount, kChannelCount, 0);
+    }
+    return folded;
+}
+
+void StimResponse::AddSpikes(const maxlab::SpikeEvent* spikes, uint64_t count) {
+    if (ring_.empty()) {
+        return;
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        const uint64_t bin = spikes[i].frameNo / config_.bin_frames;
+        // 晚到的 spike 所在 bin 已被环覆盖时丢弃
+        if (bin > current_bin_ || current_bin_ - bin > ring_mask_ || spikes[i].channel >= kChannelCount) {
+            continue;
+        }
+        ++ring_[(bin & ring_mask_) * kChannelCount + spikes[i].channel];
+    }
+}
+
+void StimResponse::Stimulus(uint64_t frame_no, int sequence) {
+    if (ring_.empty() || sequence < 1 || sequence > kResponseSequences) {
+        return;
+    }
+    if (trial_count_ == kResponseTrials) {
+        dropped_trials_.store(dropped_trials_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    trials_[(trial_head_ + trial_count_) % kResponseTrials] = {frame_no / config_.bin_frames, sequence};
+    ++trial_count_;
+}
+
+void StimResponse::Fold(const Trial& trial) {
+    const int s = trial.sequence - 1;
+    std::atomic<uint32_t>* psth = psth_.data() + static_cast<size_t>(s) * bins_ * kChannelCount;
+    uint64_t pre = 0, post = 0;
+    for (uint32_t k = 0; k < bins_; ++k) {
+        if (trial.bin + k < first_bin_ + config_.pre_bins) {
+            continue;   // 会话开始前的基线
+        }
+        const uint64_t time_bin = trial.bin + k - config_.pre_bins;
+        const uint16_t* row = ring_.data() + (time_bin & ring_mask_) * kChannelCount;
+        std::atomic<uint32_t>* cells = psth + static_cast<size_t>(k) * kChannelCount;
+        uint64_t sum = 0;
+        for (int channel = 0; channel < kChannelCount; ++channel) {
+            if (row[channel] != 0) {
+                cells[channel].store(cells[channel].load(std::memory_order_relaxed) + row[channel],
+                                     std::memory_order_relaxed);
+                sum += row[channel];
+            }
+        }
+        (k < config_.pre_bins ? pre : post) += sum;
+    }
+
+    const uint64_t trials = trials_done_[s].load(std::memory_order_relaxed) + 1;
+    pre_spikes_[s].store(pre_spikes_[s].load(std::memory_order_relaxed) + pre, std::memory_order_relaxed);
+    post_spikes_[s].store(post_spikes_[s].load(std::memory_order_relaxed) + post, std::memory_order_relaxed);
+    const double bin_s = config_.bin_frames / kFramesPerSecond;
+    const double pre_hz = config_.pre_bins > 0 ? pre / (config_.pre_bins * bin_s) : 0.0;
+    const double post_hz = post / (config_.post_bins * bin_s);
+    const double w = trials == 1 ? 1.0 : config_.recent_weight;
+    recent_pre_hz_[s].store(recent_pre_hz_[s].load(std::memory_order_relaxed) * (1 - w) + pre_hz * w,
+                            std::memory_order_relaxed);
+    recent_post_hz_[s].store(recent_post_hz_[s].load(std::memory_order_relaxed) * (1 - w) + post_hz * w,
+                             std::memory_order_relaxed);
+    // 计数最后发布，读者看到的次数不会多于已累加的 spike
+    trials_done_[s].store(trials, std::memory_order_release);
+}
+
+EvokedResponse StimResponse::Evoked(int sequence) const {
+    EvokedResponse response;
+    if (psth_.empty() || sequence < 1 || sequence > kResponseSequences) {
+        return response;
+    }
+    const int s = sequence - 1;
+    response.trials = trials_done_[s].load(std::memory_order_acquire);
+    if (response.trials == 0) {
+        return response;
+    }
+    const double bin_s = config_.bin_frames / kFramesPerSecond;
+    if (config_.pre_bins > 0) {
+        response.pre_hz = pre_spikes_[s].load(std::memory_order_relaxed) / (response.trials * config_.pre_bins * bin_s);
+    }
+    response.post_hz = post_spikes_[s].load(std::memory_order_relaxed) / (response.trials * config_.post_bins * bin_s);
+    response.recent_pre_hz = recent_pre_hz_[s].load(std::memory_order_relaxed);
+    response.recent_post_hz = recent_post_hz_[s].load(std::memory_order_relaxed);
+    return response;
+}
+
+uint32_t StimResponse::Count(int sequence, uint32_t bin, int channel) const {
+    if (psth_.empty() || sequence < 1 || sequence > kResponseSequences || bin >= bins_ || channel < 0 ||
+        channel >= kChannelCount) {
+        return 0;
+    }
+    const size_t cell = (static_cast<size_t>(sequence - 1) * bins_ + bin) * kChannelCount + channel;
+    return psth_[cell].load(std::memory_order_relaxed);
+}
+
+double StimResponse::ChannelEvokedHz(int sequence, int channel) const {
+    const uint64_t trials = Evoked(sequence).trials;
+    if (trials == 0) {
+        return 0.0;
+    }
+    uint64_t pre = 0, post = 0;
+    for (uint32_t bin = 0; bin < bins_; ++bin) {
+        (bin < config_.pre_bins ? pre : post) += Count(sequence, bin, channel);
+    }
+    const double bin_s = config_.bin_frames / kFramesPerSecond;
+    const double pre_hz = config_.pre_bins > 0 ? pre / (trials * config_.pre_bins * bin_s) : 0.0;
+    return post / (trials * config_.post_bins * bin_s) - pre_hz;
+}
+
+void StimResponse::Print(FILE* out, const char* name, const StimPolicy& policy) const {
+    for (int sequence = 1; sequence <= kResponseSequences; ++sequence) {
+        const EvokedResponse response = Evoked(sequence);
+        if (response.trials == 0) {
+            continue;
+        }
+        // 响应最强的通道
+        int best = 0;
+        double best_hz = 0;
+        for (int channel = 0; channel < kChannelCount; ++channel) {
+            const double hz = ChannelEvokedHz(sequence, channel);
+            if (hz > best_hz) {
+                best_hz = hz;
+                best = channel;
+            }
+        }
+        fprintf(out, "%s evoked %s: trials=%lu pre=%.1f Hz post=%.1f Hz (x%.2f, recent x%.2f) strongest channel %d +%.1f Hz\n",
+                name, sequence <= policy.SequenceCount() ? policy.SequenceName(sequence) : "?", response.trials,
+                response.pre_hz, response.post_hz, response.Ratio(), response.RecentRatio(), best, best_hz);
+    }
+    if (DroppedTrials() > 0) {
+        fprintf(out, "%s evoked: %lu stimuli not tracked (more than %d overlapping)\n", name, DroppedTrials(),
+                kResponseTrials);
+    }
+}
+
+StimResponseConfig StimResponseConfigFromEnv() {
+    StimResponseConfig config;
+    auto ms = [](const char* name, double fallback) {
+        const char* v = getenv(name);
+        const double value = v ? atof(v) : fallback;
+        return value >= 0 ? value : fallback;
+    };
+    const double bin_ms = ms("DINO_PSTH_BIN_MS", 5);
+    if (bin_ms * 20 >= 1) {
+        config.bin_frames = static_cast<uint32_t>(bin_ms * 20);
+    }
+    const double bin = config.bin_frames / 20.0;
+    config.pre_bins = static_cast<uint32_t>(ms("DINO_PSTH_PRE_MS", 100) / bin + 0.5);
+    config.post_bins = std::max<uint32_t>(1, static_cast<uint32_t>(ms("DINO_PSTH_POST_MS", 400) / bin + 0.5));
+    return config;
+}
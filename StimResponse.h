@@ -0,0 +1,89 @@
+#ifndef STIM_RESPONSE_H
+#define STIM_RESPONSE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "SpikeDecoder.h"
+#include "StimPolicy.h"
+
+constexpr int kResponseSequences = 4;   // 只统计序列号 1..4（默认策略只有 close_loop1、close_loop2）
+constexpr int kResponseTrials = 64;     // 同时未结束的刺激数上限，刺激间隔短于窗口时会重叠
+
+struct StimResponseConfig {
+    uint32_t bin_frames = 100;      // 5 ms
+    uint32_t pre_bins = 20;         // 刺激前 100 ms 作基线
+    uint32_t post_bins = 80;        // 刺激后 400 ms
+    double recent_weight = 0.1;     // 最近响应的指数平均中新一次刺激的权重
+};
+
+// 一个序列的诱发响应，所有通道之和；rate 为每次刺激的平均发放率
+struct EvokedResponse {
+    uint64_t trials = 0;
+    double pre_hz = 0;
+    double post_hz = 0;
+    double recent_pre_hz = 0;       // 指数平均，反映最近若干次刺激
+    double recent_post_hz = 0;
+
+    double Ratio() const { return pre_hz > 0 ? post_hz / pre_hz : 0.0; }
+    double RecentRatio() const { return recent_pre_hz > 0 ? recent_post_hz / recent_pre_hz : 0.0; }
+};
+
+// 在线 PSTH：每个 spike 只在按时间取模的环形 bin 中给本通道加一，与刺激次数无关。
+// 刺激时只记下帧号；当前 bin 越过刺激后窗口时，把环中该次刺激前后各 bin 一次性累加进对应序列的 PSTH。
+// 刺激按所在 bin 对齐，误差不超过一个 bin。
+// 只由采集线程写，PSTH 和汇总量都是单写者 relaxed 原子量，游戏线程或其他线程可随时查询
+class StimResponse {
+public:
+    bool Configure(const StimResponseConfig& config);
+    bool Configured() const { return !psth_.empty(); }
+
+    // 采集线程：每帧先推进到当前帧，再加入该帧的 spike；返回本次结束的刺激数
+    int Advance(uint64_t frame_no);
+    void AddSpikes(const maxlab::SpikeEvent* spikes, uint64_t count);
+    void Stimulus(uint64_t frame_no, int sequence);
+
+    // 任意线程
+    EvokedResponse Evoked(int sequence) const;
+    double ChannelEvokedHz(int sequence, int channel) const;    // 该通道刺激后与刺激前平均发放率之差
+    uint32_t Count(int sequence, uint32_t bin, int channel) const;  // bin 从刺激前 pre_bins 格开始
+    uint64_t DroppedTrials() const { return dropped_trials_.load(std::memory_order_relaxed); }
+    const StimResponseConfig& Config() const { return config_; }
+
+    void Print(FILE* out, const char* name, const StimPolicy& policy) const;
+
+private:
+    struct Trial {
+        uint64_t bin;
+        int sequence;
+    };
+
+    void Fold(const Trial& trial);
+
+    StimResponseConfig config_;
+    uint32_t bins_ = 0;                         // pre_bins + post_bins
+    uint64_t ring_mask_ = 0;
+    std::vector<uint16_t> ring_;                // [时间 bin 取模][通道]
+    uint64_t first_bin_ = 0;                    // 第一帧所在 bin，更早的 bin 没有数据
+    uint64_t current_bin_ = 0;
+    bool started_ = false;
+
+    Trial trials_[kResponseTrials] = {};
+    uint32_t trial_head_ = 0;                   // 最早未结束的刺激
+    uint32_t trial_count_ = 0;
+
+    // [序列][bin][通道]，序列下标为序列号 - 1
+    std::vector<std::atomic<uint32_t>> psth_;
+    std::atomic<uint64_t> trials_done_[kResponseSequences] = {};
+    std::atomic<uint64_t> pre_spikes_[kResponseSequences] = {};
+    std::atomic<uint64_t> post_spikes_[kResponseSequences] = {};
+    std::atomic<double> recent_pre_hz_[kResponseSequences] = {};
+    std::atomic<double> recent_post_hz_[kResponseSequences] = {};
+    std::atomic<uint64_t> dropped_trials_{0};   // 未结束的刺激超过 kResponseTrials
+};
+
+// DINO_PSTH_BIN_MS（默认 5）、DINO_PSTH_PRE_MS（默认 100）、DINO_PSTH_POST_MS（默认 400）
+StimResponseConfig StimResponseConfigFromEnv();
+
+#endif
@@ -0,0 +1,112 @@
+#include "StimScheduler.h"
+#include <algorithm>
+
+StimScheduler::StimScheduler() : slots_(kSlots, 0) {
+    free_.reserve(kMaxTimers);
+    Reset(0);
+}
+
+void StimScheduler::Reset(uint64_t now_frame) {
+    std::fill(slots_.begin(), slots_.end(), 0);
+    free_.clear();
+    for (uint32_t i = kMaxTimers; i >= 1; --i) {
+        timers_[i].active = false;
+        timers_[i].generation = 1;
+        free_.push_back(i);
+    }
+    now_ = now_frame;
+    active_ = 0;
+}
+
+const StimScheduler::Timer* StimScheduler::Find(StimTimerId id) const {
+    const uint32_t index = IndexOf(id);
+    if (index == 0 || index > kMaxTimers) {
+        return nullptr;
+    }
+    const Timer& timer = timers_[index];
+    if (!timer.active || timer.generation != (id >> 16)) {
+        return nullptr;
+    }
+    return &timer;
+}
+
+void StimScheduler::Link(uint32_t index) {
+    Timer& timer = timers_[index];
+    // 已经过期的定时器挂到下一个要处理的槽
+    const uint32_t slot = Slot(timer.due < now_ ? now_ : timer.due);
+    timer.slot = slot;
+    timer.prev = 0;
+    timer.next = slots_[slot];
+    if (timer.next != 0) {
+        timers_[timer.next].prev = index;
+    }
+    slots_[slot] = index;
+}
+
+void StimScheduler::Unlink(uint32_t index) {
+    Timer& timer = timers_[index];
+    if (timer.prev != 0) {
+        timers_[timer.prev].next = timer.next;
+    } else {
+        slots_[timer.slot] = timer.next;
+    }
+    if (timer.next != 0) {
+        timers_[timer.next].prev = timer.prev;
+    }
+    timer.prev = timer.next = 0;
+}
+
+void StimScheduler::Release(uint32_t index) {
+    Timer& timer = timers_[index];
+    timer.active = false;
+    timer.generation = (timer.generation + 1) & 0xffff;
+    if (timer.generation == 0) {
+        timer.generation = 1;
+    }
+    free_.push_back(index);
+    --active_;
+}
+
+StimTimerId StimScheduler::Schedule(uint64_t due_frame, int sequence) {
+    if (free_.empty()) {
+        return kNoTimer;
+    }
+    const uint32_t index = free_.back();
+    free_.pop_back();
+    Timer& timer = timers_[index];
+    timer.due = due_frame;
+    timer.sequence = sequence;
+    timer.active = true;
+    Link(index);
+    ++active_;
+    return (timer.generation << 16) | index;
+}
+
+bool StimScheduler::Cancel(StimTimerId id) {
+    if (Find(id) == nullptr) {
+        return false;
+    }
+    Unlink(IndexOf(id));
+    Release(IndexOf(id));
+    return true;
+}
+
+bool StimScheduler::Reschedule(StimTimerId id, uint64_t due_frame) {
+    if (Find(id) == nullptr) {
+        return false;
+    }
+    const uint32_t index = IndexOf(id);
+    Unlink(index);
+    timers_[index].due = due_frame;
+    Link(index);
+    return true;
+}
+
+bool StimScheduler::Pending(StimTimerId id) const {
+    return Find(id) != nullptr;
+}
+
+uint64_t StimScheduler::Due(StimTimerId id) const {
+    const Timer* timer = Find(id);
+    return timer ? timer->due : 0;
+}
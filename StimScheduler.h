@@ -0,0 +1,101 @@
+#ifndef STIM_SCHEDULER_H
+#define STIM_SCHEDULER_H
+
+#include <cstdint>
+#include <vector>
+
+using StimTimerId = uint32_t;
+constexpr StimTimerId kNoTimer = 0;
+
+// 以放大器绝对帧号为时间轴的刺激调度器（单层时间轮）
+// 定时器按到期帧号挂在 due & (kSlots - 1) 槽的双向链表上，调度/取消/改期均为 O(1)；
+// 超过一圈的定时器留在槽里，轮到时比较到期帧号再决定是否触发。
+// 只在采集线程中使用，不加锁。
+class StimScheduler {
+public:
+    static constexpr uint32_t kSlots = 1 << 16;    // 65536 帧 ≈ 3.3 s @ 20 kHz
+    static constexpr uint32_t kMaxTimers = 256;
+
+    StimScheduler();
+
+    void Reset(uint64_t now_frame);
+
+    // due_frame 不晚于当前帧时在下一次 Advance 立即触发；池满时返回 kNoTimer
+    StimTimerId Schedule(uint64_t due_frame, int sequence);
+    bool Cancel(StimTimerId id);
+    bool Reschedule(StimTimerId id, uint64_t due_frame);
+
+    bool Pending(StimTimerId id) const;
+    uint64_t Due(StimTimerId id) const;
+    uint64_t Fired() const { return fired_; }
+    uint64_t LateFrames() const { return late_frames_; }     // 因帧号跳跃而晚触发的帧数总和
+
+    // 推进到 now_frame，按到期顺序对每个到期定时器调用 fire(id, sequence, due_frame)
+    template <typename Fire>
+    void Advance(uint64_t now_frame, Fire&& fire);
+
+private:
+    struct Timer {
+        uint64_t due;
+        int sequence;
+        uint32_t generation;
+        uint32_t slot;      // 所在槽
+        uint32_t prev;      // 槽内链表，0 表示无
+        uint32_t next;
+        bool active;
+    };
+
+    static uint32_t Slot(uint64_t frame) { return static_cast<uint32_t>(frame & (kSlots - 1)); }
+    static uint32_t IndexOf(StimTimerId id) { return id & 0xffff; }
+    const Timer* Find(StimTimerId id) const;
+    void Link(uint32_t index);
+    void Unlink(uint32_t index);
+    void Release(uint32_t index);
+    template <typename Fire>
+    void FireSlot(uint32_t slot, uint64_t now_frame, Fire& fire);
+
+    std::vector<uint32_t> slots_;           // 槽 -> 链表头（定时器下标，0 表示空）
+    Timer timers_[kMaxTimers + 1];          // 下标 0 保留作空指针
+    std::vector<uint32_t> free_;
+    uint64_t now_ = 0;                      // 已处理到的帧
+    uint32_t active_ = 0;
+    uint64_t fired_ = 0;
+    uint64_t late_frames_ = 0;
+};
+
+template <typename Fire>
+void StimScheduler::FireSlot(uint32_t slot, uint64_t now_frame, Fire& fire) {
+    uint32_t index = slots_[slot];
+    while (index != 0) {
+        Timer& timer = timers_[index];
+        const uint32_t next = timer.next;
+        if (timer.due <= now_frame) {
+            const StimTimerId id = (timer.generation << 16) | index;
+            const int sequence = timer.sequence;
+            const uint64_t due = timer.due;
+            late_frames_ += now_frame - due;
+            Unlink(index);
+            Release(index);
+            ++fired_;
+            fire(id, sequence, due);
+        }
+        index = next;
+    }
+}
+
+template <typename Fire>
+void StimScheduler::Advance(uint64_t now_frame, Fire&& fire) {
+    if (now_frame < now_) {
+        return;
+    }
+    if (active_ > 0) {
+        // 帧号跳过整圈时直接扫所有槽
+        const uint64_t steps = now_frame - now_ >= kSlots ? kSlots : now_frame - now_ + 1;
+        for (uint64_t i = 0; i < steps && active_ > 0; ++i) {
+            FireSlot(Slot(now_ + i), now_frame, fire);
+        }
+    }
+    now_ = now_frame + 1;
+}
+
+#endif
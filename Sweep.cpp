@@ -0,0 +1,104 @@
+#include "Sweep.h"
+#include "ClosedLoopModel.h"
+#include <cstdlib>
+
+SweepWorker::SweepWorker() : decoder_(std::make_unique<SpikeDecoder>()) {
+}
+
+// 每个 tick：推进游戏，按距离评估刺激，再把这一 tick 内模拟出的 spike 送入解码器
+SweepRun SweepWorker::Run(const SweepParams& params, const SweepOptions& options, uint64_t seed) {
+    SweepRun run;
+
+    GameGeometry geo = DefaultGeometry();
+    geo.min_interval_half = params.min_interval_half;
+    GameState state;
+    GameReset(state, geo);
+    GameSeed(state, seed);
+
+    ResponderConfig responder = options.responder;
+    responder.evoked_spikes = params.evoked_spikes;
+    culture_.Configure(responder, seed ^ 0x5DEECE66Dull);
+
+    DecoderConfig decoder_config;
+    decoder_config.window_frames = params.window_frames;
+    decoder_config.bin_frames = options.bin_frames;
+    decoder_config.threshold = params.threshold;
+    decoder_->Configure(decoder_config);
+
+    const StimPolicy& policy = *options.policy;
+    ClosedLoopModel loop;
+    GameInput input{false, false};
+
+    for (uint64_t tick = 0; tick < options.ticks; ++tick) {
+        GameStep(state, geo, input);
+        input.jump = false;
+        if (GameCollide(state)) {
+            ++run.collisions;
+        }
+        if (state.life < 0) {
+            ++run.games;
+            run.score_sum += state.score_m / 5;
+            if (state.score_m / 5 > run.best_score) {
+                run.best_score = state.score_m / 5;
+            }
+            GameReset(state, geo);
+        }
+
+        const uint64_t frame = tick * kFramesPerTick;
+        int sequence;
+        if (loop.Evaluate(policy, calculateDistance(state), frame, params.isi_scale, sequence)) {
+            culture_.Stimulate(frame);
+            ++run.stims;
+        }
+
+        spikes_.clear();
+        culture_.Generate(frame, frame + kFramesPerTick, spikes_);
+        const bool decoded = loop.Decode(*decoder_, spikes_.data(), spikes_.size(), frame + kFramesPerTick - 1);
+
+        // 采集线程解出的跳跃由游戏线程在下一个 tick 消费
+        if (decoded) {
+            ++run.decoded_jumps;
+            input.jump = true;
+        }
+    }
+    run.last_score = state.score_m / 5;
+    if (run.last_score > run.best_score) {
+        run.best_score = run.last_score;
+    }
+    return run;
+}
+
+bool ParseSweepAxis(const char* text, std::vector<double>& values) {
+    values.clear();
+    char* end;
+    const double first = strtod(text, &end);
+    if (end == text) {
+        return false;
+    }
+    if (*end == ':') {
+        const char* p = end + 1;
+        const double last = strtod(p, &end);
+        if (end == p || *end != ':') {
+            return false;
+        }
+        p = end + 1;
+        const double step = strtod(p, &end);
+        if (end == p || *end != '\0' || step <= 0 || last < first) {
+            return false;
+        }
+        // 步长为小数时容许累计误差，终点包含在内
+        for (int i = 0; first + i * step <= last + step * 1e-9; ++i) {
+            values.push_back(first + i * step);
+        }
+        return true;
+    }
+    values.push_back(first);
+    while (*end == ',') {
+        const char* p = end + 1;
+        values.push_back(strtod(p, &end));
+        if (end == p) {
+            return false;
+        }
+    }
+    return *end == '\0';
+}
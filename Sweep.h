@@ -0,0 +1,58 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GameState.h"
+#include "Responder.h"
+#include "SpikeDecoder.h"
+#include "StimPolicy.h"
+
+// 一组扫参参数，对应结果表中的一行
+struct SweepParams {
+    uint32_t threshold = 10;            // 解码阈值
+    uint32_t window_frames = 1000;      // 解码窗口（帧），须为 SweepOptions::bin_frames 的整数倍
+    double isi_scale = 1.0;             // 策略表中 ISI 的缩放
+    int min_interval_half = MinInterval_Half;
+    float evoked_spikes = 12.f;         // 覆盖 ResponderConfig::evoked_spikes
+};
+
+// 所有任务共用的设置
+struct SweepOptions {
+    uint64_t ticks = 20000;             // 每个任务推进的 tick 数
+    uint32_t bin_frames = 100;
+    ResponderConfig responder;
+    const StimPolicy* policy = nullptr;
+};
+
+// 一个任务（一组参数 × 一个种子）的结果
+struct SweepRun {
+    uint64_t games = 0;                 // 结束的局数
+    uint64_t collisions = 0;
+    uint64_t stims = 0;
+    uint64_t decoded_jumps = 0;         // 解码出跳跃的 tick 数
+    uint64_t score_sum = 0;             // 结束各局的得分之和
+    unsigned long best_score = 0;
+    unsigned long last_score = 0;       // 最后一局（未结束）的得分
+};
+
+// 每个工作线程一份，解码器有几百 KB，不随任务反复分配
+class SweepWorker {
+public:
+    SweepWorker();
+
+    SweepRun Run(const SweepParams& params, const SweepOptions& options, uint64_t seed);
+
+private:
+    std::unique_ptr<SpikeDecoder> decoder_;
+    SimulatedCulture culture_;
+    std::vector<maxlab::SpikeEvent> spikes_;
+};
+
+// "a,b,c" 或 "起:止:步长"（含终点），失败返回 false
+bool ParseSweepAxis(const char* text, std::vector<double>& values);
+
+#endif
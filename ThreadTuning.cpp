@@ -0,0 +1,103 @@
+#include "ThreadTuning.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+static inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ volatile("yield");
+#endif
+}
+
+FrameWaiter::FrameWaiter(WaitMode mode, uint32_t spin_limit, uint32_t sleep_us)
+    : mode_(mode), spin_limit_(spin_limit), sleep_us_(sleep_us) {}
+
+void FrameWaiter::Idle() {
+    ++empty_polls_;
+    switch (mode_) {
+        case WaitMode::Spin:
+            break;
+
+        case WaitMode::SpinPause:
+            CpuRelax();
+            break;
+
+        case WaitMode::SpinSleep:
+            if (++spins_ < spin_limit_) {
+                CpuRelax();
+            } else {
+                ++sleeps_;
+                std::this_thread::sleep_for(std::chrono::microseconds(sleep_us_));
+            }
+            break;
+    }
+}
+
+void FrameWaiter::Received() {
+    spins_ = 0;
+}
+
+FrameWaiter FrameWaiterFromEnv() {
+    // 默认先自旋再睡眠，空闲时不占满一个核；纯自旋和 pause 自旋须显式选择
+    WaitMode mode = WaitMode::SpinSleep;
+    if (const char* v = getenv("DINO_WAIT")) {
+        if (strcmp(v, "spin") == 0) {
+            mode = WaitMode::Spin;
+        } else if (strcmp(v, "pause") == 0) {
+            mode = WaitMode::SpinPause;
+        } else if (strcmp(v, "sleep") != 0) {
+            fprintf(stderr, "Invalid DINO_WAIT=%s, using sleep\n", v);
+        }
+    }
+    const char* spins = getenv("DINO_WAIT_SPINS");
+    const char* sleep_us = getenv("DINO_WAIT_SLEEP_US");
+    return FrameWaiter(mode, spins ? strtoul(spins, nullptr, 10) : 200, sleep_us ? strtoul(sleep_us, nullptr, 10) : 50);
+}
+
+ThreadPolicy ThreadPolicyFromEnv(const char* role) {
+    ThreadPolicy policy;
+    char name[64];
+    snprintf(name, sizeof(name), "DINO_%s_CPU", role);
+    if (const char* v = getenv(name)) {
+        policy.cpu = atoi(v);
+    }
+    snprintf(name, sizeof(name), "DINO_%s_FIFO", role);
+    if (const char* v = getenv(name)) {
+        policy.fifo_priority = atoi(v);
+    }
+    return policy;
+}
+
+bool ApplyThreadPolicy(const char* role, const ThreadPolicy& policy) {
+    bool ok = true;
+    if (policy.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(policy.cpu, &set);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err != 0) {
+            fprintf(stderr, "%s: cannot pin to cpu %d: %s\n", role, policy.cpu, strerror(err));
+            ok = false;
+        }
+    }
+    if (policy.fifo_priority > 0) {
+        sched_param param{};
+        param.sched_priority = policy.fifo_priority;
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0) {
+            fprintf(stderr, "%s: cannot set SCHED_FIFO %d: %s\n", role, policy.fifo_priority, strerror(err));
+            ok = false;
+        }
+    }
+    return ok;
+}
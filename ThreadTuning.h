@@ -0,0 +1,48 @@
+#ifndef THREAD_TUNING_H
+#define THREAD_TUNING_H
+
+#include <cstdint>
+
+// 采集循环在 MAXLAB_NO_FRAME 时的等待方式
+enum class WaitMode {
+    Spin,       // 纯自旋，延迟最低，占满一个核
+    SpinPause,  // 自旋并执行 pause/yield 指令，减少对超线程兄弟核和功耗的影响
+    SpinSleep,  // 连续空轮询超过 spin_limit 次后睡眠 sleep_us
+};
+
+class FrameWaiter {
+public:
+    FrameWaiter(WaitMode mode, uint32_t spin_limit, uint32_t sleep_us);
+
+    void Idle();            // 本次轮询没有帧
+    void Received();        // 收到一帧
+
+    uint64_t EmptyPolls() const { return empty_polls_; }
+    uint64_t Sleeps() const { return sleeps_; }
+    WaitMode Mode() const { return mode_; }
+
+private:
+    WaitMode mode_;
+    uint32_t spin_limit_;
+    uint32_t sleep_us_;
+    uint32_t spins_ = 0;
+    uint64_t empty_polls_ = 0;
+    uint64_t sleeps_ = 0;
+};
+
+// 从 DINO_WAIT（sleep 默认 / pause / spin）、DINO_WAIT_SPINS（默认 200）、DINO_WAIT_SLEEP_US（默认 50）读取
+FrameWaiter FrameWaiterFromEnv();
+
+// 线程的 CPU 亲和性与实时优先级
+struct ThreadPolicy {
+    int cpu = -1;           // <0 不绑定
+    int fifo_priority = 0;  // >0 时使用 SCHED_FIFO
+};
+
+// 从 DINO_<role>_CPU / DINO_<role>_FIFO 读取，role 为 ACQ、STIM、RENDER
+ThreadPolicy ThreadPolicyFromEnv(const char* role);
+
+// 作用于调用线程，失败时打印原因并返回 false（通常是缺少 CAP_SYS_NICE）
+bool ApplyThreadPolicy(const char* role, const ThreadPolicy& policy);
+
+#endif
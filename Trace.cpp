@@ -0,0 +1,115 @@
+#include "Trace.h"
+#include "Latency.h"
+#include "SpscRing.h"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+std::atomic<int> trace_level(Trace_Info);
+
+static const char* const kTraceFormats[TraceIdCount] = {
+    "distance(thread): %ld frame=%ld",
+    "isi(thread): %ld frame=%ld",
+    "decoder window count(thread): %ld frame=%ld",
+    "jump(thread) frame=%ld spikes=%ld",
+    "stim sequence=%ld frame=%ld",
+    "stim error status=%ld frame=%ld",
+    "frame gap missing=%ld frame=%ld",
+    "deadline missed lag=%ld frames frame=%ld",
+};
+
+using TraceBuffer = SpscRing<TraceRecord, 8192>;
+
+static std::mutex trace_mutex;                              // 只在注册新线程和启停时使用
+static std::vector<std::unique_ptr<TraceBuffer>> trace_buffers;
+static std::thread trace_thread;
+static std::atomic<bool> trace_running(false);
+static FILE* trace_out = nullptr;
+static bool trace_binary = false;
+static uint64_t trace_origin_ns = 0;
+
+static thread_local TraceBuffer* local_buffer = nullptr;
+static thread_local uint16_t local_thread = 0;
+
+void TraceWrite(TraceId id, int64_t a, int64_t b) {
+    if (local_buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(trace_mutex);
+        trace_buffers.push_back(std::make_unique<TraceBuffer>());
+        local_buffer = trace_buffers.back().get();
+        local_thread = static_cast<uint16_t>(trace_buffers.size() - 1);
+    }
+    local_buffer->Push({MonotonicNs(), a, b, id, local_thread, 0});
+}
+
+static void TraceEmit(const TraceRecord& record) {
+    if (trace_binary) {
+        fwrite(&record, sizeof(record), 1, trace_out);
+        return;
+    }
+    fprintf(trace_out, "[%12.6f] t%u ", (record.ts_ns - trace_origin_ns) / 1e9, record.thread);
+    fprintf(trace_out, kTraceFormats[record.id], record.a, record.b);
+    fputc('\n', trace_out);
+}
+
+static void TraceDrain() {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    TraceRecord record;
+    for (auto& buffer : trace_buffers) {
+        while (buffer->Pop(record)) {
+            TraceEmit(record);
+        }
+    }
+    fflush(trace_out);
+}
+
+static void TraceLoop() {
+    while (trace_running.load(std::memory_order_acquire)) {
+        TraceDrain();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    TraceDrain();
+}
+
+void TraceStart(const char* path) {
+    if (trace_running.load()) {
+        return;
+    }
+    trace_out = stdout;
+    trace_binary = false;
+    if (path != nullptr && path[0] != '\0') {
+        const size_t len = strlen(path);
+        trace_binary = len > 4 && strcmp(path + len - 4, ".bin") == 0;
+        trace_out = fopen(path, trace_binary ? "wb" : "w");
+        if (trace_out == nullptr) {
+            fprintf(stderr, "Failed to open trace file %s\n", path);
+            trace_out = stdout;
+            trace_binary = false;
+        }
+    }
+    trace_origin_ns = MonotonicNs();
+    trace_running = true;
+    trace_thread = std::thread(TraceLoop);
+}
+
+void TraceStop() {
+    if (!trace_running.exchange(false)) {
+        return;
+    }
+    trace_thread.join();
+    if (trace_out != stdout) {
+        fclose(trace_out);
+    }
+    trace_out = nullptr;
+}
+
+uint64_t TraceDropped() {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    uint64_t dropped = 0;
+    for (auto& buffer : trace_buffers) {
+        dropped += buffer->Dropped();
+    }
+    return dropped;
+}
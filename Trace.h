@@ -0,0 +1,54 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+
+// 二进制跟踪日志：热路径只写一条定长记录到本线程的无锁环形队列，
+// 由后台线程格式化输出或直接写二进制文件
+
+enum TraceLevel {
+    Trace_Off = 0,
+    Trace_Info = 1,     // 解码事件、刺激等低频事件
+    Trace_Debug = 2,    // 每帧一条：距离、isi
+};
+
+// 记录类型，格式串见 Trace.cpp 中的 kTraceFormats
+enum TraceId : uint16_t {
+    Trace_Distance,     // a=distance  b=frame
+    Trace_Isi,          // a=距下次刺激评估的帧数  b=frame
+    Trace_SpikeCount,   // a=窗口内选中通道 spike 数  b=frame
+    Trace_Jump,         // a=frame     b=spikes
+    Trace_Stim,         // a=sequence  b=frame
+    Trace_StimError,    // a=status    b=frame
+    Trace_FrameGap,     // a=缺失帧数  b=缺口后的第一帧
+    Trace_Deadline,     // a=滞后帧数  b=frame，由按时转为超期时记一条
+    TraceIdCount,
+};
+
+struct TraceRecord {
+    uint64_t ts_ns;
+    int64_t a;
+    int64_t b;
+    uint16_t id;
+    uint16_t thread;
+    uint32_t reserved;
+};
+
+extern std::atomic<int> trace_level;
+
+// 关闭时只有一次 relaxed load 和一次比较
+#define TRACE(level, id, a, b)                                                  \
+    do {                                                                        \
+        if ((level) <= trace_level.load(std::memory_order_relaxed))             \
+            TraceWrite((id), static_cast<int64_t>(a), static_cast<int64_t>(b)); \
+    } while (0)
+
+void TraceWrite(TraceId id, int64_t a, int64_t b);
+
+// path 为空时输出到 stdout；以 .bin 结尾时写原始 TraceRecord
+void TraceStart(const char* path);
+void TraceStop();
+uint64_t TraceDropped();
+
+#endif
@@ -0,0 +1,82 @@
+#include "Wells.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+WellLayout::WellLayout() {
+    memset(slot, -1, sizeof(slot));
+    slot[0] = 0;
+}
+
+WellLayout WellLayoutFromEnv() {
+    WellLayout layout;
+    const char* value = getenv("DINO_WELLS");
+    if (value == nullptr || *value == '\0') {
+        return layout;
+    }
+    WellLayout parsed;
+    memset(parsed.slot, -1, sizeof(parsed.slot));
+    parsed.count = 0;
+    const char* p = value;
+    while (*p != '\0') {
+        char* end;
+        const long well = strtol(p, &end, 10);
+        if (end == p || well < 0 || well > 255 || parsed.slot[well] >= 0 || parsed.count == kMaxWells ||
+            (*end != ',' && *end != '\0')) {
+            fprintf(stderr, "Invalid DINO_WELLS=%s, using a single well\n", value);
+            return layout;
+        }
+        parsed.slot[well] = static_cast<int8_t>(parsed.count);
+        parsed.ids[parsed.count++] = static_cast<uint8_t>(well);
+        p = *end == ',' ? end + 1 : end;
+    }
+    if (parsed.count == 0) {
+        return layout;
+    }
+    parsed.demux = true;
+    return parsed;
+}
+
+const char* WellSequenceName(const WellLayout& layout, int slot, const char* sequence, char* buffer, size_t size) {
+    if (!layout.demux) {
+        return sequence;
+    }
+    snprintf(buffer, size, "%s_w%u", sequence, layout.ids[slot]);
+    return buffer;
+}
+
+void WellDemux::Configure(const WellLayout& layout) {
+    layout_ = layout;
+    for (int i = 0; i < layout_.count; ++i) {
+        spikes_[i].clear();
+        spikes_[i].reserve(1024);
+        counts_[i] = 0;
+    }
+    unrouted_ = 0;
+}
+
+void WellDemux::Split(const maxlab::SpikeEvent* spikes, uint64_t count) {
+    if (!layout_.demux) {
+        passthrough_ = spikes;
+        counts_[0] = count;
+        return;
+    }
+    for (int i = 0; i < layout_.count; ++i) {
+        spikes_[i].clear();
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        const int slot = layout_.slot[spikes[i].wellId];
+        if (slot < 0) {
+            ++unrouted_;
+            continue;
+        }
+        spikes_[slot].push_back(spikes[i]);
+    }
+    for (int i = 0; i < layout_.count; ++i) {
+        counts_[i] = spikes_[i].size();
+    }
+}
+
+const maxlab::SpikeEvent* WellDemux::Spikes(int slot) const {
+    return layout_.demux ? spikes_[slot].data() : passthrough_;
+}
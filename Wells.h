@@ -0,0 +1,46 @@
+#ifndef WELLS_H
+#define WELLS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "maxlab/include/maxlab/spike_event.h"
+
+constexpr int kMaxWells = 24;   // MaxTwo 24 孔板
+
+// 参与游戏的井：每个井一局游戏、一个解码器和一个刺激调度器，第 0 路显示在窗口中。
+// 单井时不看 wellId，所有 spike 都归第 0 路，与 MaxOne 上的行为一致
+struct WellLayout {
+    int count = 1;
+    bool demux = false;
+    uint8_t ids[kMaxWells] = {};    // 第 i 路对应的井号
+    int8_t slot[256];               // 井号 -> 路，-1 表示不参与
+
+    WellLayout();
+};
+
+// DINO_WELLS：井号列表，如 "0,1,2,3,4,5"；未设置或非法时为单井
+WellLayout WellLayoutFromEnv();
+
+// 多井时刺激序列按井区分：策略表中的 close_loop1 在井 3 上发送 close_loop1_w3，须在配置脚本中为每个井各准备一份
+const char* WellSequenceName(const WellLayout& layout, int slot, const char* sequence, char* buffer, size_t size);
+
+// 把一帧的 spike 按井号分到各路，各路内保持原有顺序；不参与的井计入 Unrouted
+class WellDemux {
+public:
+    void Configure(const WellLayout& layout);
+    void Split(const maxlab::SpikeEvent* spikes, uint64_t count);
+
+    const maxlab::SpikeEvent* Spikes(int slot) const;
+    uint64_t Count(int slot) const { return counts_[slot]; }
+    uint64_t Unrouted() const { return unrouted_; }
+
+private:
+    WellLayout layout_;
+    std::vector<maxlab::SpikeEvent> spikes_[kMaxWells];
+    uint64_t counts_[kMaxWells] = {};
+    const maxlab::SpikeEvent* passthrough_ = nullptr;   // 单井时直接引用原数组
+    uint64_t unrouted_ = 0;
+};
+
+#endif
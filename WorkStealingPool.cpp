@@ -0,0 +1,69 @@
+#include "WorkStealingPool.h"
+#include <thread>
+
+WorkStealingPool::WorkStealingPool(unsigned threads) : threads_(threads) {
+    if (threads_ == 0) {
+        threads_ = std::thread::hardware_concurrency();
+    }
+    if (threads_ == 0) {
+        threads_ = 1;
+    }
+    for (unsigned i = 0; i < threads_; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+}
+
+bool WorkStealingPool::Pop(unsigned worker, size_t& job) {
+    Queue& queue = *queues_[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) {
+        return false;
+    }
+    job = queue.jobs.back();
+    queue.jobs.pop_back();
+    return true;
+}
+
+// 从下一个线程开始轮询，偷走对方最早分到的任务，与对方取任务的一端错开
+bool WorkStealingPool::Steal(unsigned worker, size_t& job) {
+    for (unsigned k = 1; k < threads_; ++k) {
+        Queue& victim = *queues_[(worker + k) % threads_];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            stolen_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::Run(size_t count, const std::function<void(size_t, unsigned)>& job) {
+    // 相邻任务参数相近、耗时相近，连续分段后负载不均主要来自参数区间之间，由窃取摊平
+    for (unsigned w = 0; w < threads_; ++w) {
+        const size_t first = count * w / threads_;
+        const size_t last = count * (w + 1) / threads_;
+        std::lock_guard<std::mutex> lock(queues_[w]->mutex);
+        for (size_t i = first; i < last; ++i) {
+            queues_[w]->jobs.push_back(i);
+        }
+    }
+
+    // 任务只在开始时入队，自己和别人的队列都空了就可以退出
+    auto worker = [&](unsigned w) {
+        size_t index;
+        while (Pop(w, index) || Steal(w, index)) {
+            job(index, w);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned w = 1; w < threads_; ++w) {
+        workers.emplace_back(worker, w);
+    }
+    worker(0);
+    for (auto& t : workers) {
+        t.join();
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// 工作窃取线程池：任务按连续区段预先分给各线程，线程从自己队列尾部取，
+// 空了以后从其他线程队列头部偷。任务粒度是一整局仿真（毫秒到秒级），队列用互斥锁即可。
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads = 0);    // 0 表示使用全部硬件线程
+
+    // 执行 job(index, worker)，index 取 [0, count)，阻塞到全部完成
+    void Run(size_t count, const std::function<void(size_t, unsigned)>& job);
+
+    unsigned Threads() const { return threads_; }
+    uint64_t Stolen() const { return stolen_.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<size_t> jobs;
+    };
+
+    bool Pop(unsigned worker, size_t& job);
+    bool Steal(unsigned worker, size_t& job);
+
+    unsigned threads_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::atomic<uint64_t> stolen_{0};
+};
+
+#endif
@@ -0,0 +1,140 @@
+#include "Analysis.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// 用法: Dino_analyse <record_dir>... [--threads N] [--policy FILE] [--pre MS] [--post MS] [--bin MS] [--chunk S] [--out PREFIX]
+// 一个或多个 DINO_RECORD_DIR 会话一起分析，结果汇总到 <PREFIX>_channels.csv、<PREFIX>_psth.csv、<PREFIX>_jumps.csv；
+// 序列名取自会话记录，--policy 只用于没有记录序列名的旧会话
+static void Usage(const char* name) {
+    fprintf(stderr, "Call with: %s <record_dir>... [--threads N] [--policy FILE] [--pre MS] [--post MS] [--bin MS]\n"
+                    "           [--chunk S] [--out PREFIX]\n", name);
+}
+
+// 距离直方图的中位数所在格，没有跳跃时为 -1
+static int MedianBin(const uint64_t* histogram) {
+    uint64_t total = 0;
+    for (int bin = 0; bin < kDistanceBins; ++bin) {
+        total += histogram[bin];
+    }
+    uint64_t seen = 0;
+    for (int bin = 0; bin < kDistanceBins; ++bin) {
+        seen += histogram[bin];
+        if (total > 0 && seen * 2 >= total) {
+            return bin;
+        }
+    }
+    return -1;
+}
+
+static void PrintJumps(const char* label, const uint64_t* histogram) {
+    uint64_t total = 0;
+    for (int bin = 0; bin < kDistanceBins; ++bin) {
+        total += histogram[bin];
+    }
+    const int median = MedianBin(histogram);
+    if (median < 0) {
+        printf("  %s jumps 0\n", label);
+    } else if (median + 1 < kDistanceBins) {
+        printf("  %s jumps %lu, median obstacle distance %d-%d px\n", label, total, median * kDistanceBin,
+               (median + 1) * kDistanceBin);
+    } else {
+        printf("  %s jumps %lu, median obstacle distance beyond %d px\n", label, total, median * kDistanceBin);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> dirs;
+    AnalysisOptions options;
+    const char* policy_path = "stim_policy.cfg";
+    std::string prefix = "analysis";
+    int i = 1;
+    for (; i < argc && strncmp(argv[i], "--", 2) != 0; ++i) {
+        dirs.push_back(argv[i]);
+    }
+    for (; i + 1 < argc; i += 2) {
+        const char* value = argv[i + 1];
+        if (strcmp(argv[i], "--threads") == 0) {
+            options.threads = strtoul(value, nullptr, 10);
+        } else if (strcmp(argv[i], "--policy") == 0) {
+            policy_path = value;
+        } else if (strcmp(argv[i], "--pre") == 0) {
+            options.pre_frames = static_cast<uint32_t>(atof(value) * 20);
+        } else if (strcmp(argv[i], "--post") == 0) {
+            options.post_frames = static_cast<uint32_t>(atof(value) * 20);
+        } else if (strcmp(argv[i], "--bin") == 0) {
+            options.bin_frames = static_cast<uint32_t>(atof(value) * 20);
+        } else if (strcmp(argv[i], "--chunk") == 0) {
+            options.chunk_frames = static_cast<uint64_t>(atof(value) * 20000);
+        } else if (strcmp(argv[i], "--out") == 0) {
+            prefix = value;
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if (dirs.empty() || i != argc) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    StimPolicyStore policies;
+    policies.Reload(policy_path);
+    const StimPolicy& policy = *policies.Current();
+
+    const auto start = std::chrono::steady_clock::now();
+    AnalysisResult result;
+    if (!AnalyseSessions(dirs, options, policy, result)) {
+        return 1;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t frames = 0;
+    for (const WellAnalysis& well : result.wells) {
+        const double duration = well.frames / 20000.0;
+        uint64_t spikes = 0;
+        for (uint64_t count : well.channel_spikes) {
+            spikes += count;
+        }
+        frames = std::max(frames, well.frames);
+        printf("well %u: %.1f s, %lu spikes (%.1f/s, %.3f Hz per channel), %lu games, mean score %.1f, collisions %lu\n",
+               well.well, duration, spikes, duration > 0 ? spikes / duration : 0.0,
+               duration > 0 ? spikes / duration / kChannelCount : 0.0, well.games,
+               well.games > 0 ? static_cast<double>(well.score_sum) / well.games : 0.0, well.collisions);
+        for (int s = 0; s <= kAnalysisSequences; ++s) {
+            const uint64_t trials = well.stims[s];
+            if (trials == 0) {
+                continue;
+            }
+            uint64_t pre = 0, post = 0;
+            for (int channel = 0; channel < kChannelCount; ++channel) {
+                pre += well.channel_pre[channel * (kAnalysisSequences + 1) + s];
+                post += well.channel_post[channel * (kAnalysisSequences + 1) + s];
+            }
+            const double pre_rate = options.pre_frames > 0 ? pre / (trials * options.pre_frames / 20000.0) : 0.0;
+            const double post_rate = options.post_frames > 0 ? post / (trials * options.post_frames / 20000.0) : 0.0;
+            printf("  %-16s stims %6lu  pre %9.1f/s  post %9.1f/s (x%.2f)  jump within %.0f ms %lu (%.1f%%, mean %.1f ms)\n",
+                   result.sequence_names[s].c_str(), trials, pre_rate, post_rate,
+                   pre_rate > 0 ? post_rate / pre_rate : 0.0, options.post_frames / 20.0, well.evoked_jumps[s],
+                   100.0 * well.evoked_jumps[s] / trials,
+                   well.evoked_jumps[s] > 0 ? well.evoked_latency_frames[s] / 20.0 / well.evoked_jumps[s] : 0.0);
+        }
+        PrintJumps("decoded", well.decoded_jumps);
+        PrintJumps("game", well.game_jumps);
+    }
+    if (result.other_well_spikes > 0) {
+        printf("%lu spikes from wells without game events\n", result.other_well_spikes);
+    }
+    printf("%lu sessions, %.1f min of recordings, %lu spikes analysed in %.3f s (%.0fx real time), "
+           "%u threads, %lu chunks (%lu stolen)\n",
+           result.sessions, frames / 20000.0 / 60, result.spikes, seconds,
+           seconds > 0 ? frames / 20000.0 / seconds : 0.0, result.threads, result.chunks, result.stolen);
+
+    if (!WriteAnalysis(result, options, prefix)) {
+        return 1;
+    }
+    printf("wrote %s_channels.csv, %s_psth.csv, %s_jumps.csv\n", prefix.c_str(), prefix.c_str(), prefix.c_str());
+    return 0;
+}
@@ -0,0 +1,335 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "GameState.h"
+#include "Globals.h"
+#include "Acquisition.h"
+#include "RawDetector.h"
+#include "Renderer.h"
+#include "maxlab/include/maxlab/data_streamer.h"
+
+// 用法: Dino_bench [--filter 子串] [--min-time 毫秒] [--repeat N]
+// 每项报告 ns/op、allocs/op、bytes/op（经由 operator new 的分配；SDL 内部的 malloc 不计入）
+
+// ---- 分配计数 ----
+
+static std::atomic<uint64_t> g_allocs{0};
+static std::atomic<uint64_t> g_alloc_bytes{0};
+
+static void* CountedAlloc(size_t bytes, size_t align) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    void* p = align > alignof(std::max_align_t) ? aligned_alloc(align, (bytes + align - 1) / align * align) : malloc(bytes ? bytes : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(size_t bytes) { return CountedAlloc(bytes, 0); }
+void* operator new[](size_t bytes) { return CountedAlloc(bytes, 0); }
+void* operator new(size_t bytes, std::align_val_t align) { return CountedAlloc(bytes, static_cast<size_t>(align)); }
+void* operator new[](size_t bytes, std::align_val_t align) { return CountedAlloc(bytes, static_cast<size_t>(align)); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { free(p); }
+
+// ---- 计时框架 ----
+
+// 阻止编译器把结果当作无用代码删掉
+template <typename T>
+static inline void Keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct BenchOptions {
+    const char* filter = nullptr;
+    double min_seconds = 0.2;
+    int repeat = 5;
+};
+
+static BenchOptions g_options;
+
+struct Sample {
+    double ns_per_op;
+    double allocs_per_op;
+    double bytes_per_op;
+};
+
+template <typename Op>
+static Sample RunOnce(Op& op, uint64_t iterations) {
+    const uint64_t allocs = g_allocs.load(std::memory_order_relaxed);
+    const uint64_t bytes = g_alloc_bytes.load(std::memory_order_relaxed);
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        op(i);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return Sample{ns / iterations,
+                  static_cast<double>(g_allocs.load(std::memory_order_relaxed) - allocs) / iterations,
+                  static_cast<double>(g_alloc_bytes.load(std::memory_order_relaxed) - bytes) / iterations};
+}
+
+static bool Selected(const char* name) {
+    return g_options.filter == nullptr || strstr(name, g_options.filter) != nullptr;
+}
+
+// 先按 10 倍递增迭代次数直到单轮超过 10 ms，再按 min-time 定迭代次数，重复 repeat 轮取中位数
+template <typename Op>
+static void Bench(const char* name, Op op) {
+    if (!Selected(name)) {
+        return;
+    }
+    uint64_t iterations = 1;
+    Sample sample = RunOnce(op, iterations);
+    while (sample.ns_per_op * iterations < 1e7 && iterations < (1ull << 40)) {
+        iterations *= 10;
+        sample = RunOnce(op, iterations);
+    }
+    iterations = std::max<uint64_t>(1, static_cast<uint64_t>(g_options.min_seconds * 1e9 / sample.ns_per_op));
+
+    std::vector<Sample> samples;
+    for (int r = 0; r < g_options.repeat; ++r) {
+        samples.push_back(RunOnce(op, iterations));
+    }
+    std::sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b) { return a.ns_per_op < b.ns_per_op; });
+    const Sample& median = samples[samples.size() / 2];
+    printf("%-36s %12.1f ns/op %10.3f allocs/op %10.1f B/op %12lu iters\n",
+           name, median.ns_per_op, median.allocs_per_op, median.bytes_per_op, iterations);
+}
+
+// ---- 测试数据 ----
+
+static const GameGeometry g_geo = DefaultGeometry();
+
+// 一局中按固定间隔取 64 个状态，覆盖不同的障碍物组合和跳跃阶段
+static std::vector<GameState> SampleStates() {
+    std::vector<GameState> states;
+    GameState state;
+    GameReset(state, g_geo);
+    GameSeed(state, 1);
+    for (int tick = 0; states.size() < 64; ++tick) {
+        GameInput input{tick % 53 == 0, false};
+        GameStep(state, g_geo, input);
+        if (tick % 37 == 0) {
+            states.push_back(state);
+        }
+    }
+    return states;
+}
+
+// 合成的滤波流帧：每帧 spike 数服从泊松分布，均值 rate
+struct SyntheticFrames {
+    std::vector<maxlab::SpikeEvent> spikes;
+    std::vector<maxlab::FilteredFrameData> frames;
+    std::vector<size_t> first;
+
+    SyntheticFrames(double rate, size_t count) : first(count) {
+        std::mt19937 rng(7);
+        std::poisson_distribution<int> per_frame(rate);
+        std::uniform_int_distribution<int> channel(0, kChannelCount - 1);
+        std::vector<size_t> number(count);
+        for (size_t f = 0; f < count; ++f) {
+            first[f] = spikes.size();
+            number[f] = per_frame(rng);
+            for (size_t n = 0; n < number[f]; ++n) {
+                maxlab::SpikeEvent spike;
+                spike.channel = static_cast<uint16_t>(channel(rng));
+                spike.amp = -50.f;
+                spikes.push_back(spike);
+            }
+        }
+        for (size_t f = 0; f < count; ++f) {
+            frames.push_back({number[f], spikes.data() + first[f]});
+        }
+    }
+
+    // 合成帧循环使用，取出时把 spike 的帧号改成 frame_no
+    const maxlab::FilteredFrameData& Frame(size_t f, uint64_t frame_no) {
+        for (size_t i = 0; i < frames[f].spikeCount; ++i) {
+            spikes[first[f] + i].frameNo = frame_no;
+        }
+        return frames[f];
+    }
+};
+
+// 采集线程一帧的处理，与 message_thread 共用 AcquisitionLoop::FilteredFrame：
+// 帧号与缺口检测 → 记录 → 计数 → 按井分发 → 各井在线 PSTH、解码、查策略表、定时器、提交刺激、解码事件。
+// 刺激线程不启动（不调用 sendSequence），命令只入队或合并；游戏线程的部分在这里约每 500 帧做一次：
+// 推进一个 tick、发布障碍物距离、取空解码事件队列。会话记录器不启动，与未设置 DINO_RECORD_DIR 时相同
+struct AcquisitionBench {
+    AcquisitionLoop acquisition;
+    StimDispatcher dispatcher;
+    std::vector<GameState> games;
+    uint64_t frame_no = 0;
+
+    AcquisitionBench() {
+        acquisition.Configure(false);
+        games.resize(well_layout.count);
+        for (int slot = 0; slot < well_layout.count; ++slot) {
+            GameReset(games[slot], g_geo);
+            GameSeed(games[slot], 1);
+            // 各项从头开始累计在线 PSTH
+            if (!well_links[slot].response.Configure(StimResponseConfigFromEnv())) {
+                well_links[slot].response.Configure(StimResponseConfig());
+            }
+        }
+    }
+
+    uint64_t Step(SyntheticFrames& source, size_t f) {
+        if ((frame_no & 511) == 0) {
+            for (int slot = 0; slot < well_layout.count; ++slot) {
+                GameStep(games[slot], g_geo, GameInput{false, false});
+                well_links[slot].obstacle_distance.store(calculateDistance(games[slot]), std::memory_order_relaxed);
+                DecoderEvent ev;
+                while (well_links[slot].decoder_events.Pop(ev)) {
+                }
+            }
+        }
+        ++frame_no;
+        acquisition.FilteredFrame(dispatcher, source.Frame(f, frame_no), MonotonicNs());
+        return acquisition.frame_no;
+    }
+};
+
+// 空白贴图加资源包（DINO_ASSET_PACK，默认 assets.pak）或字体中的分数字符
+static bool PrepareRenderer(Renderer& renderer) {
+    if (!renderer.InitializeOffscreen(64, 64)) {
+        return false;
+    }
+    SDL_Surface* sprites[SpriteCount];
+    for (int i = 0; i < SpriteCount; ++i) {
+        sprites[i] = SDL_CreateRGBSurfaceWithFormat(0, 32, 32, 32, SDL_PIXELFORMAT_RGBA32);
+    }
+    AssetPack pack;
+    const char* pack_path = getenv("DINO_ASSET_PACK");
+    if (pack.Open(pack_path ? pack_path : "assets.pak")) {
+        return renderer.BuildAtlas(sprites, pack);
+    }
+    TTF_Init();
+    TTF_Font* font = TTF_OpenFont(kScoreFontPath, kScoreFontSize);
+    if (font == nullptr) {
+        for (SDL_Surface* surface : sprites) {
+            SDL_FreeSurface(surface);
+        }
+        return false;
+    }
+    const bool ok = renderer.BuildAtlas(sprites, font, kTextColor);
+    TTF_CloseFont(font);
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--filter") == 0) {
+            g_options.filter = argv[i + 1];
+        } else if (strcmp(argv[i], "--min-time") == 0) {
+            g_options.min_seconds = atof(argv[i + 1]) / 1000.0;
+        } else if (strcmp(argv[i], "--repeat") == 0) {
+            g_options.repeat = std::max(1, atoi(argv[i + 1]));
+        } else {
+            fprintf(stderr, "Call with: %s [--filter SUBSTRING] [--min-time MS] [--repeat N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (argc % 2 == 0) {
+        fprintf(stderr, "Call with: %s [--filter SUBSTRING] [--min-time MS] [--repeat N]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<GameState> states = SampleStates();
+
+    Bench("calculateDistance", [&](uint64_t i) {
+        const GameState& state = states[i & 63];
+        Keep(calculateDistance(state));
+    });
+    Bench("TicksToCollision", [&](uint64_t i) {
+        Keep(TicksToCollision(states[i & 63]));
+    });
+
+    // DinoGame::CD() 去掉日志和记录后的部分
+    Bench("GameCollide (CD)", [&](uint64_t i) {
+        Keep(GameCollide(states[i & 63]));
+    });
+
+    GameState running;
+    GameReset(running, g_geo);
+    GameSeed(running, 2);
+    Bench("GameStep (obstacle update)", [&](uint64_t i) {
+        GameStep(running, g_geo, GameInput{i % 97 == 0, false});
+        Keep(running.obstacles.x[0]);
+    });
+
+    // 最密的合法间距加三成鸟，池中同时有更多障碍物
+    GameGeometry dense_geo = g_geo;
+    dense_geo.spawn_spacing = 2 * dense_geo.min_interval_half + 151;
+    dense_geo.bird_percent = 30;
+    GameState dense;
+    GameReset(dense, dense_geo);
+    GameSeed(dense, 2);
+    Bench("GameStep, dense obstacles", [&](uint64_t) {
+        GameStep(dense, dense_geo, GameInput{false, false});
+        Keep(dense.obstacles.count);
+    });
+
+    // 与游戏进程共用全局的刺激策略和各井通道；井数取 DINO_WELLS
+    stim_policies.Reload(StimPolicyPath());
+    SyntheticFrames quiet(0.05, 4096);      // 约 1000 spike/s
+    SyntheticFrames burst(4.0, 4096);       // 约 80000 spike/s
+    {
+        AcquisitionBench quiet_loop;
+        Bench("acquisition frame, 0.05 spikes/frame", [&](uint64_t i) {
+            Keep(quiet_loop.Step(quiet, i & 4095));
+        });
+    }
+    {
+        AcquisitionBench burst_loop;
+        Bench("acquisition frame, 4 spikes/frame", [&](uint64_t i) {
+            Keep(burst_loop.Step(burst, i & 4095));
+        });
+    }
+
+    RawDetector detector;
+    detector.Configure(RawDetectorConfig());
+    std::vector<float> raw(64 * kChannelCount);
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.f, 10.f);
+    for (float& sample : raw) {
+        sample = noise(rng);
+    }
+    Bench("RawDetector::Process (1024 ch)", [&](uint64_t i) {
+        Keep(detector.Process(i, &raw[(i & 63) * kChannelCount]));
+    });
+
+    const char* score_name = "Renderer::Clear + RenderScore";
+    const char* clear_name = "Renderer::Clear (64x64 baseline)";
+    if (Selected(score_name) || Selected(clear_name)) {
+        Renderer renderer;
+        if (PrepareRenderer(renderer)) {
+            SDL_Rect score_rect;
+            Bench(score_name, [&](uint64_t i) {
+                renderer.Clear();
+                renderer.RenderScore(i, score_rect);
+            });
+            Bench(clear_name, [&](uint64_t) {
+                renderer.Clear();
+            });
+        } else {
+            printf("%-36s skipped: no assets.pak (DINO_ASSET_PACK) or %s\n", "Renderer::RenderScore", kScoreFontPath);
+        }
+    }
+    return 0;
+}
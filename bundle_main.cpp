@@ -0,0 +1,164 @@
+// 资源打包工具：把 images/ 下的贴图和预光栅化的字体合成一个 assets.pak
+// 用法：Dino_bundle [-o assets.pak] [-C 资源根目录]
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "AssetPack.h"
+
+struct PendingEntry {
+    PackEntry entry;
+    SDL_Surface* surface;   // RGBA32，空格等无像素项为 nullptr
+};
+
+static bool AddSurface(std::vector<PendingEntry>& pending, const char* name, PackKind kind, SDL_Surface* loaded,
+                       int advance = 0, int line_height = 0) {
+    PendingEntry item{};
+    snprintf(item.entry.name, sizeof(item.entry.name), "%s", name);
+    item.entry.kind = kind;
+    item.entry.advance = advance;
+    item.entry.line_height = line_height;
+    if (loaded != nullptr) {
+        item.surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(loaded);
+        if (item.surface == nullptr) {
+            fprintf(stderr, "convert %s: %s\n", name, SDL_GetError());
+            return false;
+        }
+        item.entry.width = item.surface->w;
+        item.entry.height = item.surface->h;
+        item.entry.pitch = item.surface->w * 4;
+        item.entry.bytes = uint64_t(item.entry.pitch) * item.entry.height;
+    }
+    pending.push_back(item);
+    return true;
+}
+
+static bool AddGlyphs(std::vector<PendingEntry>& pending, const char* font_name, const char* path, int size, const char* charset) {
+    TTF_Font* font = TTF_OpenFont(path, size);
+    if (font == nullptr) {
+        fprintf(stderr, "open font %s: %s\n", path, TTF_GetError());
+        return false;
+    }
+    bool ok = true;
+    const int line_height = TTF_FontHeight(font);
+    for (const char* p = charset; *p && ok; ++p) {
+        int minx, maxx, miny, maxy, advance;
+        if (TTF_GlyphMetrics(font, static_cast<unsigned char>(*p), &minx, &maxx, &miny, &maxy, &advance) != 0) {
+            fprintf(stderr, "glyph '%c' missing in %s\n", *p, path);
+            ok = false;
+            break;
+        }
+        char name[sizeof(PackEntry::name)];
+        snprintf(name, sizeof(name), "%s:%c", font_name, *p);
+        SDL_Surface* glyph = *p == ' ' ? nullptr : TTF_RenderGlyph_Blended(font, static_cast<unsigned char>(*p), kTextColor);
+        ok = AddSurface(pending, name, Pack_Glyph, glyph, advance, line_height);
+    }
+    TTF_CloseFont(font);
+    return ok;
+}
+
+static bool WritePack(const char* path, std::vector<PendingEntry>& pending) {
+    // 目录之后依次排列像素，每项 64 字节对齐
+    uint64_t offset = AlignPack(sizeof(PackHeader) + pending.size() * sizeof(PackEntry));
+    for (PendingEntry& item : pending) {
+        item.entry.offset = offset;
+        offset = AlignPack(offset + item.entry.bytes);
+    }
+    PackHeader header{};
+    memcpy(header.magic, kPackMagic, sizeof(kPackMagic));
+    header.version = kPackVersion;
+    header.entry_count = static_cast<uint32_t>(pending.size());
+    header.file_bytes = offset;
+
+    // 先写临时文件再改名，游戏不会读到写了一半的包
+    const std::string tmp = std::string(path) + ".tmp";
+    FILE* out = fopen(tmp.c_str(), "wb");
+    if (out == nullptr) {
+        perror(tmp.c_str());
+        return false;
+    }
+    std::vector<uint8_t> file(offset, 0);
+    memcpy(file.data(), &header, sizeof(header));
+    for (size_t i = 0; i < pending.size(); ++i) {
+        const PendingEntry& item = pending[i];
+        memcpy(file.data() + sizeof(header) + i * sizeof(PackEntry), &item.entry, sizeof(PackEntry));
+        if (item.surface == nullptr) {
+            continue;
+        }
+        SDL_LockSurface(item.surface);
+        const uint8_t* src = static_cast<const uint8_t*>(item.surface->pixels);
+        for (uint32_t row = 0; row < item.entry.height; ++row) {
+            memcpy(file.data() + item.entry.offset + row * item.entry.pitch, src + row * item.surface->pitch, item.entry.pitch);
+        }
+        SDL_UnlockSurface(item.surface);
+    }
+    const bool ok = fwrite(file.data(), 1, file.size(), out) == file.size();
+    if (fclose(out) != 0 || !ok || rename(tmp.c_str(), path) != 0) {
+        perror(path);
+        return false;
+    }
+    printf("%s: %zu entries, %lu bytes\n", path, pending.size(), static_cast<unsigned long>(offset));
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    const char* output = "assets.pak";
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "-C") == 0 && i + 1 < argc) {
+            if (chdir(argv[++i]) != 0) {
+                perror(argv[i]);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "usage: %s [-o assets.pak] [-C asset_root]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    IMG_Init(IMG_INIT_PNG);
+    TTF_Init();
+    std::vector<PendingEntry> pending;
+    bool ok = true;
+
+    for (int i = 0; i < kImageAssetCount && ok; ++i) {
+        SDL_Surface* image = IMG_Load(kImageAssets[i].path);
+        if (image == nullptr) {
+            fprintf(stderr, "load %s: %s\n", kImageAssets[i].path, IMG_GetError());
+            ok = false;
+            break;
+        }
+        ok = AddSurface(pending, kImageAssets[i].name, Pack_Image, image);
+    }
+    ok = ok && AddGlyphs(pending, "score", kScoreFontPath, kScoreFontSize, kScoreCharset);
+    if (ok) {
+        TTF_Font* font = TTF_OpenFont(kGameoverFontPath, kGameoverFontSize);
+        SDL_Surface* text = font ? TTF_RenderUTF8_Blended(font, kGameoverText, kTextColor) : nullptr;
+        if (text == nullptr) {
+            fprintf(stderr, "render game over text: %s\n", TTF_GetError());
+            ok = false;
+        } else {
+            ok = AddSurface(pending, "gameover", Pack_Text, text);
+        }
+        if (font) {
+            TTF_CloseFont(font);
+        }
+    }
+
+    ok = ok && WritePack(output, pending);
+    for (PendingEntry& item : pending) {
+        if (item.surface) {
+            SDL_FreeSurface(item.surface);
+        }
+    }
+    TTF_Quit();
+    IMG_Quit();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+#include "Metrics.h"
+#include "Latency.h"
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+
+// 用法: Dino_dash [--name /dino_metrics] [--interval MS] [--once 1]
+// 只读映射游戏进程的计数器段，每个周期打印一次速率和量值；游戏进程结束后退出
+static void Usage(const char* name) {
+    fprintf(stderr, "Call with: %s [--name SHM_NAME] [--interval MS] [--once 1]\n", name);
+}
+
+// 一次采样：把共享内存中的计数器拷成普通整数
+struct Sample {
+    uint64_t ns = 0;
+    uint64_t frames = 0, empty_polls = 0, spikes = 0, stims_merged = 0, stims_dropped = 0, jumps_decoded = 0, last_frame = 0;
+    uint64_t missing_frames = 0, corrupted_frames = 0, late_frames = 0, lag_frames = 0, max_backlog = 0;
+    uint64_t stims = 0, stim_errors = 0, queue_ns = 0, send_ns = 0, send_max_ns = 0;
+    uint64_t ticks = 0, overruns = 0, dropped_ticks = 0, renders = 0, render_ns = 0, render_max_ns = 0, jumps_consumed = 0;
+    uint32_t sequences = 0;
+    uint64_t by_sequence[kMetricsSequences] = {};
+    uint64_t well_stims[kMaxWells] = {}, well_jumps[kMaxWells] = {}, well_games[kMaxWells] = {};
+    uint64_t well_score[kMaxWells] = {}, well_best[kMaxWells] = {}, well_distance[kMaxWells] = {};
+    uint64_t evoked_trials[kMaxWells][kResponseSequences] = {}, evoked_permille[kMaxWells][kResponseSequences] = {};
+};
+
+static uint64_t Load(const MetricCounter& counter) {
+    return counter.load(std::memory_order_relaxed);
+}
+
+static Sample Take(const MetricsSegment& segment) {
+    Sample s;
+    s.ns = MonotonicNs();
+    const AcquisitionMetrics& acq = segment.acquisition;
+    s.frames = Load(acq.frames);
+    s.empty_polls = Load(acq.empty_polls);
+    s.spikes = Load(acq.spikes);
+    s.stims_merged = Load(acq.stims_merged);
+    s.stims_dropped = Load(acq.stims_dropped);
+    s.jumps_decoded = Load(acq.jumps_decoded);
+    s.last_frame = Load(acq.last_frame);
+    s.missing_frames = Load(acq.missing_frames);
+    s.corrupted_frames = Load(acq.corrupted_frames);
+    s.late_frames = Load(acq.late_frames);
+    s.lag_frames = Load(acq.lag_frames);
+    s.max_backlog = Load(acq.max_backlog);
+    const StimMetrics& stim = segment.stim;
+    s.stims = Load(stim.stims);
+    s.stim_errors = Load(stim.errors);
+    s.queue_ns = Load(stim.queue_ns);
+    s.send_ns = Load(stim.send_ns);
+    s.send_max_ns = Load(stim.send_max_ns);
+    const GameMetrics& game = segment.game;
+    s.ticks = Load(game.ticks);
+    s.overruns = Load(game.overruns);
+    s.dropped_ticks = Load(game.dropped_ticks);
+    s.renders = Load(game.renders);
+    s.render_ns = Load(game.render_ns);
+    s.render_max_ns = Load(game.render_max_ns);
+    s.jumps_consumed = Load(game.jumps_consumed);
+    s.sequences = segment.sequence_count.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < s.sequences; ++i) {
+        s.by_sequence[i] = Load(segment.stims_by_sequence[i]);
+    }
+    for (uint32_t w = 0; w < segment.wells && w < kMaxWells; ++w) {
+        const WellMetrics& well = segment.well[w];
+        s.well_stims[w] = Load(well.stims);
+        s.well_jumps[w] = Load(well.jumps_decoded);
+        s.well_games[w] = Load(well.games);
+        s.well_score[w] = Load(well.score);
+        s.well_best[w] = Load(well.best_score);
+        s.well_distance[w] = Load(well.distance);
+        for (int q = 0; q < kResponseSequences; ++q) {
+            s.evoked_trials[w][q] = Load(well.evoked_trials[q]);
+            s.evoked_permille[w][q] = Load(well.evoked_permille[q]);
+        }
+    }
+    return s;
+}
+
+static void Print(const MetricsSegment& segment, const Sample& a, const Sample& b, bool clear) {
+    const double dt = (b.ns - a.ns) / 1e9;
+    auto rate = [dt](uint64_t from, uint64_t to) { return dt > 0 ? (to - from) / dt : 0.0; };
+    const uint64_t polls = (b.frames - a.frames) + (b.empty_polls - a.empty_polls);
+    const uint64_t renders = b.renders - a.renders;
+    const uint64_t stims = b.stims - a.stims;
+
+    if (clear) {
+        printf("\033[H\033[2J");
+    }
+    printf("session %.1f s, frame %lu\n", (b.ns - segment.start_ns) / 1e9, b.last_frame);
+    printf("acquisition  frames %9.0f/s  no-frame %5.1f%%  spikes %9.0f/s  jumps decoded %lu (+%lu)\n",
+           rate(a.frames, b.frames), polls > 0 ? 100.0 * (b.empty_polls - a.empty_polls) / polls : 0.0,
+           rate(a.spikes, b.spikes), b.jumps_decoded, b.jumps_decoded - a.jumps_decoded);
+    printf("stream       missing %lu (+%lu)  corrupted %lu (+%lu)  late %lu (+%lu)  lag %.2f ms  max backlog %lu\n",
+           b.missing_frames, b.missing_frames - a.missing_frames, b.corrupted_frames,
+           b.corrupted_frames - a.corrupted_frames, b.late_frames, b.late_frames - a.late_frames,
+           b.lag_frames / 20.0, b.max_backlog);
+    printf("game         ticks %6.1f/s  overruns %lu (+%lu)  dropped ticks %lu  jumps consumed %lu\n",
+           rate(a.ticks, b.ticks), b.overruns, b.overruns - a.overruns, b.dropped_ticks, b.jumps_consumed);
+    printf("render       %6.1f fps  mean %7.1f us  max %7.1f us\n", rate(a.renders, b.renders),
+           renders > 0 ? (b.render_ns - a.render_ns) / 1e3 / renders : 0.0, b.render_max_ns / 1e3);
+    printf("stims        total %lu (%.1f/s)  errors %lu  merged %lu  dropped %lu\n", b.stims, rate(a.stims, b.stims),
+           b.stim_errors, b.stims_merged, b.stims_dropped);
+    printf("stim thread  queue mean %7.1f us  send mean %7.1f us  max %7.1f us\n",
+           stims > 0 ? (b.queue_ns - a.queue_ns) / 1e3 / stims : 0.0,
+           stims > 0 ? (b.send_ns - a.send_ns) / 1e3 / stims : 0.0, b.send_max_ns / 1e3);
+    for (uint32_t i = 0; i < b.sequences; ++i) {
+        const uint64_t before = i < a.sequences ? a.by_sequence[i] : 0;
+        printf("  %-31s %8lu  %6.1f/s\n", segment.sequence_names[i], b.by_sequence[i], rate(before, b.by_sequence[i]));
+    }
+    // 最近的诱发响应：刺激后/前发放率之比，按序列号（策略表中的顺序）
+    for (uint32_t w = 0; w < segment.wells && w < kMaxWells; ++w) {
+        bool any = false;
+        for (int q = 0; q < kResponseSequences; ++q) {
+            if (b.evoked_trials[w][q] == 0) {
+                continue;
+            }
+            if (!any) {
+                printf("evoked well %-3u", segment.well_ids[w]);
+                any = true;
+            }
+            printf("  seq %d x%.2f (%lu trials)", q + 1, b.evoked_permille[w][q] / 1000.0, b.evoked_trials[w][q]);
+        }
+        if (any) {
+            printf("\n");
+        }
+    }
+    if (segment.wells > 1) {
+        printf("well   games   score    best  distance     stims  jumps decoded\n");
+        for (uint32_t w = 0; w < segment.wells && w < kMaxWells; ++w) {
+            char distance[16];
+            if (b.well_distance[w] >= INT_MAX) {
+                snprintf(distance, sizeof(distance), "-");
+            } else {
+                snprintf(distance, sizeof(distance), "%lu", b.well_distance[w]);
+            }
+            printf("%4u %7lu %7lu %7lu %9s %9lu %14lu\n", segment.well_ids[w], b.well_games[w], b.well_score[w],
+                   b.well_best[w], distance, b.well_stims[w], b.well_jumps[w]);
+        }
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char* argv[]) {
+    const char* name = MetricsNameFromEnv();
+    unsigned interval_ms = 1000;
+    bool once = false;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--name") == 0) {
+            name = argv[i + 1];
+        } else if (strcmp(argv[i], "--interval") == 0) {
+            interval_ms = strtoul(argv[i + 1], nullptr, 10);
+        } else if (strcmp(argv[i], "--once") == 0) {
+            once = atoi(argv[i + 1]) != 0;
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if (argc % 2 == 0 || interval_ms == 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    const int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        fprintf(stderr, "No metrics segment %s (is the game running?)\n", name);
+        return 1;
+    }
+    void* map = mmap(nullptr, sizeof(MetricsSegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Failed to map metrics segment %s\n", name);
+        return 1;
+    }
+    const MetricsSegment& segment = *static_cast<const MetricsSegment*>(map);
+    if (memcmp(segment.magic, kMetricsMagic, sizeof(kMetricsMagic)) != 0 || segment.version != kMetricsVersion) {
+        fprintf(stderr, "Metrics segment %s has an unknown layout\n", name);
+        munmap(map, sizeof(MetricsSegment));
+        return 1;
+    }
+
+    const bool clear = !once && isatty(STDOUT_FILENO);
+    Sample previous = Take(segment);
+    do {
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+        const Sample current = Take(segment);
+        Print(segment, previous, current, clear);
+        previous = current;
+    } while (!once && segment.alive.load(std::memory_order_acquire) != 0);
+    if (segment.alive.load(std::memory_order_acquire) == 0) {
+        printf("session ended\n");
+    }
+    munmap(map, sizeof(MetricsSegment));
+    return 0;
+}
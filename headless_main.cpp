@@ -0,0 +1,49 @@
+#include "Headless.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// 用法: Dino_headless [--ticks N] [--seed S] [--autopilot D] [--spacing PX] [--birds PERCENT]
+static void Usage(const char* name) {
+    fprintf(stderr, "Call with: %s [--ticks N] [--seed S] [--autopilot D] [--spacing PX] [--birds PERCENT]\n", name);
+}
+
+int main(int argc, char* argv[]) {
+    HeadlessOptions options;
+    GameGeometry geo = DefaultGeometry();
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--ticks") == 0) {
+            options.ticks = strtoull(argv[i + 1], nullptr, 10);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            options.seed = static_cast<unsigned int>(strtoul(argv[i + 1], nullptr, 10));
+        } else if (strcmp(argv[i], "--autopilot") == 0) {
+            options.autopilot_distance = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--spacing") == 0) {
+            geo.spawn_spacing = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--birds") == 0) {
+            geo.bird_percent = atoi(argv[i + 1]);
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if (argc % 2 == 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    if (MaxMinIntervalHalf(geo) < geo.min_interval_half) {
+        fprintf(stderr, "spacing %d too small for the widest obstacle\n", geo.spawn_spacing);
+        return 1;
+    }
+    if (geo.bird_percent < 0 || geo.bird_percent > 100) {
+        fprintf(stderr, "birds %d out of range [0, 100]\n", geo.bird_percent);
+        return 1;
+    }
+
+    HeadlessResult result = RunHeadless(options, geo);
+    printf("ticks=%lu games=%lu collisions=%lu jumps=%lu best_score=%lu\n",
+           result.ticks, result.games, result.collisions, result.jumps, result.best_score);
+    printf("%.3f s, %.0f ticks/s\n", result.seconds, result.seconds > 0 ? result.ticks / result.seconds : 0.0);
+    return 0;
+}
@@ -2,12 +2,11 @@
 #include <iostream>
 
 int main(int argc, char* argv[]) {
-    DinoGame game; // 创建游戏对象
-    game.PrepareAll(); // 准备所有的资源和窗口
+    DinoGame game; // 创建游戏对象，构造时加载资源并建好图集
 
     // 渲染游戏的主菜单
     game.renderer.Clear();
-    game.renderer.RenderTexture(Dino_menu_Texture, nullptr, &Dino_menu_Rect);
+    game.renderer.RenderSprite(Sprite_DinoMenu, nullptr, Dino_menu_Rect);
     game.renderer.Present();
 
     bool gameRunning = true;
@@ -31,8 +30,8 @@ int main(int argc, char* argv[]) {
                         // 清屏并渲染游戏开始界面
                         std::cout << "SPACE PRESSED" << std::endl;
                         game.renderer.Clear();
-                        game.renderer.RenderTexture(Blinking_Texture, nullptr, TheDINO_Rect);
-                        game.renderer.RenderTexture(Road_Texture, nullptr, Road_Rect);
+                        game.renderer.RenderSprite(Sprite_Blinking, nullptr, game_state.dino[0]);
+                        game.renderer.RenderSprite(Sprite_Road, nullptr, game_state.road[0]);
                         game.renderer.Present();
 
                         // 执行跳跃逻辑并进入游戏主循环
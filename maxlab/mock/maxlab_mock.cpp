@@ -0,0 +1,406 @@
+/**
+ * @file maxlab_mock.cpp
+ *
+ * 本地替身：实现与 libmaxlab 相同的 maxlab:: 接口，不需要 mxwserver。
+ * spike 来源由环境变量选择：
+ *   MAXLAB_MOCK_SOURCE   poisson（默认）| burst | replay
+ *   MAXLAB_MOCK_RATE     每通道发放率 Hz，默认 5
+ *   MAXLAB_MOCK_CHANNELS 通道数，默认 1024
+ *   MAXLAB_MOCK_WELLS    井数，默认 1；合成的 spike 随机分到井 0 ~ N-1（滤波流）
+ *   MAXLAB_MOCK_BURST_HZ / MAXLAB_MOCK_BURST_MS / MAXLAB_MOCK_BURST_GAIN  burst 频率、时长、发放率倍数
+ *   MAXLAB_MOCK_FILE     replay 文件，每行 "frameNo channel amp [wellId]"，按帧号升序
+ *   MAXLAB_MOCK_LOOP     replay 到结尾后是否从头开始，默认 0
+ *   MAXLAB_MOCK_REALTIME 是否按 20 kHz 墙钟节奏出帧，默认 1；0 表示尽可能快
+ *   MAXLAB_MOCK_DROP     每帧丢失的概率（帧号跳过），默认 0
+ *   MAXLAB_MOCK_CORRUPT  原始流每帧标记为 corrupted 的概率，默认 0
+ *   MAXLAB_MOCK_SEED     随机种子
+ *   MAXLAB_MOCK_LOG      sendSequence 日志文件，默认 stderr
+ */
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "../include/maxlab/versions.h"
+#include "../include/maxlab/errors.h"
+#include "../include/maxlab/api_comm.h"
+#include "../include/maxlab/data_streamer.h"
+#include "../include/maxlab/spike_event.h"
+
+namespace maxlab
+{
+namespace
+{
+constexpr double kSampleRate = 20000.0;
+constexpr int kMaxChannels = 1024;
+
+enum class Source
+{
+    Poisson,
+    Burst,
+    Replay,
+};
+
+double envDouble(const char *name, double fallback)
+{
+    const char *value = getenv(name);
+    return value ? atof(value) : fallback;
+}
+
+struct MockStream
+{
+    bool filteredOpen = false;
+    bool rawOpen = false;
+    FilterType filterType = FilterType::FIR;
+
+    Source source = Source::Poisson;
+    double rate = 5;
+    int channels = kMaxChannels;
+    int wells = 1;
+    double burstHz = 1;
+    double burstFrames = 50 * kSampleRate / 1000;
+    double burstGain = 50;
+    bool loop = false;
+    bool realtime = true;
+    double dropRate = 0;
+    double corruptRate = 0;
+
+    std::mt19937_64 rng;
+    std::atomic<uint64_t> nextFrame{0};    // 收流线程递增，sendSequence 在调用方的刺激线程上读
+    uint64_t firstFrame = 0;
+    uint64_t burstLeft = 0;
+    std::chrono::steady_clock::time_point start;
+
+    std::vector<SpikeEvent> replay;
+    size_t replayPos = 0;
+
+    std::vector<SpikeEvent> spikes;
+    std::vector<float> amplitudes;
+    std::vector<int> waveformPos;       // 原始流中各通道正在叠加的 spike 波形位置，-1 表示无
+    std::vector<float> waveformGain;
+
+    FILE *log = stderr;
+    std::mutex logMutex;
+
+    void configure()
+    {
+        const char *src = getenv("MAXLAB_MOCK_SOURCE");
+        if (src && strcmp(src, "burst") == 0)
+            source = Source::Burst;
+        else if (src && strcmp(src, "replay") == 0)
+            source = Source::Replay;
+        else
+            source = Source::Poisson;
+
+        rate = envDouble("MAXLAB_MOCK_RATE", 5);
+        channels = static_cast<int>(envDouble("MAXLAB_MOCK_CHANNELS", kMaxChannels));
+        if (channels < 1 || channels > kMaxChannels)
+            channels = kMaxChannels;
+        wells = static_cast<int>(envDouble("MAXLAB_MOCK_WELLS", 1));
+        if (wells < 1 || wells > 256)
+            wells = 1;
+        burstHz = envDouble("MAXLAB_MOCK_BURST_HZ", 1);
+        burstFrames = envDouble("MAXLAB_MOCK_BURST_MS", 50) * kSampleRate / 1000;
+        burstGain = envDouble("MAXLAB_MOCK_BURST_GAIN", 50);
+        loop = envDouble("MAXLAB_MOCK_LOOP", 0) != 0;
+        realtime = envDouble("MAXLAB_MOCK_REALTIME", 1) != 0;
+        dropRate = envDouble("MAXLAB_MOCK_DROP", 0);
+        corruptRate = envDouble("MAXLAB_MOCK_CORRUPT", 0);
+        rng.seed(static_cast<uint64_t>(envDouble("MAXLAB_MOCK_SEED", 1)));
+
+        const char *logPath = getenv("MAXLAB_MOCK_LOG");
+        if (logPath && log == stderr)
+        {
+            FILE *f = fopen(logPath, "w");
+            if (f)
+                log = f;
+            else
+                fprintf(stderr, "maxlab mock: cannot open log %s\n", logPath);
+        }
+
+        if (source == Source::Replay)
+            loadReplay(getenv("MAXLAB_MOCK_FILE"));
+
+        spikes.reserve(kMaxChannels);
+        amplitudes.assign(kMaxChannels, 0.f);
+        waveformPos.assign(kMaxChannels, -1);
+        waveformGain.assign(kMaxChannels, 0.f);
+        burstLeft = 0;
+        nextFrame = firstFrame;
+        start = std::chrono::steady_clock::now();
+    }
+
+    void loadReplay(const char *path)
+    {
+        replay.clear();
+        replayPos = 0;
+        firstFrame = 0;
+        FILE *f = path ? fopen(path, "r") : nullptr;
+        if (!f)
+        {
+            fprintf(stderr, "maxlab mock: cannot open replay file %s\n", path ? path : "(MAXLAB_MOCK_FILE unset)");
+            return;
+        }
+        char line[256];
+        while (fgets(line, sizeof(line), f))
+        {
+            unsigned long frameNo;
+            unsigned channel, wellId = 0;
+            float amp;
+            if (sscanf(line, "%lu %u %f %u", &frameNo, &channel, &amp, &wellId) < 3 || channel >= kMaxChannels)
+                continue;
+            SpikeEvent event;
+            event.frameNo = frameNo;
+            event.channel = static_cast<uint16_t>(channel);
+            event.amp = amp;
+            event.wellId = static_cast<unsigned char>(wellId);
+            replay.push_back(event);
+        }
+        fclose(f);
+        if (!replay.empty())
+            firstFrame = replay.front().frameNo;
+        fprintf(stderr, "maxlab mock: loaded %zu spikes from %s\n", replay.size(), path);
+    }
+
+    // 实时模式下，下一帧是否已经"到达"
+    bool frameDue() const
+    {
+        if (!realtime)
+            return true;
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return static_cast<double>(nextFrame - firstFrame) < elapsed * kSampleRate;
+    }
+
+    void synthesize(uint64_t frame)
+    {
+        double perChannel = rate / kSampleRate;
+        if (source == Source::Burst)
+        {
+            if (burstLeft == 0 && std::bernoulli_distribution(burstHz / kSampleRate)(rng))
+                burstLeft = static_cast<uint64_t>(burstFrames);
+            if (burstLeft > 0)
+            {
+                --burstLeft;
+                perChannel *= burstGain;
+            }
+        }
+
+        std::poisson_distribution<int> count(perChannel * channels);
+        std::uniform_int_distribution<int> channel(0, channels - 1);
+        std::normal_distribution<float> amp(-60.f, 15.f);
+        std::uniform_int_distribution<int> well(0, wells - 1);
+        int n = count(rng);
+        if (n > kMaxChannels)
+            n = kMaxChannels;
+        for (int i = 0; i < n; ++i)
+        {
+            SpikeEvent event;
+            event.frameNo = frame;
+            event.channel = static_cast<uint16_t>(channel(rng));
+            event.amp = amp(rng);
+            if (wells > 1)
+                event.wellId = static_cast<unsigned char>(well(rng));
+            spikes.push_back(event);
+        }
+    }
+
+    bool replayFrame(uint64_t frame)
+    {
+        if (replayPos >= replay.size())
+        {
+            if (!loop || replay.empty())
+                return false;
+            // 从头再放，帧号继续递增
+            const uint64_t shift = frame - firstFrame;
+            for (SpikeEvent &event : replay)
+                event.frameNo += shift;
+            firstFrame = frame;
+            replayPos = 0;
+        }
+        while (replayPos < replay.size() && replay[replayPos].frameNo < frame)
+            ++replayPos;
+        while (replayPos < replay.size() && replay[replayPos].frameNo == frame && spikes.size() < kMaxChannels)
+            spikes.push_back(replay[replayPos++]);
+        return true;
+    }
+
+    // 生成下一帧的 spike，没有帧时返回 false
+    bool nextSpikes(uint64_t &frame)
+    {
+        if (!frameDue())
+            return false;
+        spikes.clear();
+        // 丢失的帧照样占用时间，只是不交给调用方
+        while (dropRate > 0 && std::bernoulli_distribution(dropRate)(rng))
+            ++nextFrame;
+        frame = nextFrame;
+        if (source == Source::Replay)
+        {
+            if (!replayFrame(frame))
+                return false;
+        }
+        else
+        {
+            synthesize(frame);
+        }
+        ++nextFrame;
+        return true;
+    }
+};
+
+MockStream &stream()
+{
+    static MockStream instance;
+    return instance;
+}
+} // namespace
+
+const char *getStaticLibraryVersion()
+{
+    return MAXLAB_PUBLIC_API_VERSION;
+}
+
+void verifyStatus(Status status)
+{
+    if (status != MAXLAB_OK)
+    {
+        fprintf(stderr, "maxlab mock: call failed with status %d\n", static_cast<int>(status));
+        exit(1);
+    }
+}
+
+Status sendSequence(const char *sequenceName)
+{
+    MockStream &s = stream();
+    std::lock_guard<std::mutex> lock(s.logMutex);
+    fprintf(s.log, "frame=%lu sequence=%s\n", static_cast<unsigned long>(s.nextFrame.load(std::memory_order_relaxed)), sequenceName);
+    fflush(s.log);
+    return MAXLAB_OK;
+}
+
+Response sendRaw(const char *message)
+{
+    Response response;
+    const char *reply = strcmp(message, "get_errors") == 0 ? "" : "Ok";
+    response.content = static_cast<char *>(malloc(strlen(reply) + 1));
+    strcpy(response.content, reply);
+    response.status = MAXLAB_OK;
+    return response;
+}
+
+Status freeResponse(Response *response)
+{
+    if (!response)
+        return MAXLAB_INVALID_INPUT;
+    free(response->content);
+    response->content = nullptr;
+    return MAXLAB_OK;
+}
+
+Status DataStreamerFiltered_open(FilterType filterType)
+{
+    MockStream &s = stream();
+    if (s.filteredOpen || s.rawOpen)
+        return MAXLAB_STREAM_ALREADY_OPENED;
+    s.filterType = filterType;
+    s.configure();
+    s.filteredOpen = true;
+    return MAXLAB_OK;
+}
+
+Status DataStreamerFiltered_close()
+{
+    stream().filteredOpen = false;
+    return MAXLAB_OK;
+}
+
+Status DataStreamerFiltered_receiveNextFrame(FilteredFrameData *frameData)
+{
+    MockStream &s = stream();
+    if (!frameData)
+        return MAXLAB_INVALID_INPUT;
+    if (!s.filteredOpen)
+        return MAXLAB_STREAM_NOT_OPENED;
+    uint64_t frame;
+    if (!s.nextSpikes(frame))
+        return MAXLAB_NO_FRAME;
+    frameData->spikeCount = s.spikes.size();
+    frameData->spikeEvents = s.spikes.data();
+    return MAXLAB_OK;
+}
+
+Status DataStreamerFiltered_setFilterType(FilterType filterType)
+{
+    MockStream &s = stream();
+    if (!s.filteredOpen)
+        return MAXLAB_STREAM_NOT_OPENED;
+    s.filterType = filterType;
+    return MAXLAB_OK;
+}
+
+FilterType DataStreamerFiltered_getFilterType()
+{
+    return stream().filterType;
+}
+
+Status DataStreamerRaw_open()
+{
+    MockStream &s = stream();
+    if (s.filteredOpen || s.rawOpen)
+        return MAXLAB_STREAM_ALREADY_OPENED;
+    s.configure();
+    s.rawOpen = true;
+    return MAXLAB_OK;
+}
+
+Status DataStreamerRaw_close()
+{
+    stream().rawOpen = false;
+    return MAXLAB_OK;
+}
+
+Status DataStreamerRaw_receiveNextFrame(RawFrameData *frameData)
+{
+    MockStream &s = stream();
+    if (!frameData)
+        return MAXLAB_INVALID_INPUT;
+    if (!s.rawOpen)
+        return MAXLAB_STREAM_NOT_OPENED;
+    uint64_t frame;
+    if (!s.nextSpikes(frame))
+        return MAXLAB_NO_FRAME;
+
+    // 背景噪声 + 在 spike 通道上叠加约 0.6 ms 的双相波形，谷值为 spike 幅值
+    static const float waveform[12] = {-0.15f, -0.45f, -0.85f, -1.f, -0.7f, -0.3f, 0.05f, 0.25f, 0.3f, 0.2f, 0.1f, 0.05f};
+    std::normal_distribution<float> noise(0.f, 8.f);
+    for (float &amplitude : s.amplitudes)
+        amplitude = noise(s.rng);
+    for (const SpikeEvent &event : s.spikes)
+    {
+        s.waveformPos[event.channel] = 0;
+        s.waveformGain[event.channel] = -event.amp;
+    }
+    for (int channel = 0; channel < kMaxChannels; ++channel)
+    {
+        int &pos = s.waveformPos[channel];
+        if (pos < 0)
+            continue;
+        s.amplitudes[channel] += waveform[pos] * s.waveformGain[channel];
+        if (++pos == 12)
+            pos = -1;
+    }
+
+    frameData->frameInfo.frame_number = frame;
+    frameData->frameInfo.well_id = 0;
+    frameData->frameInfo.corrupted = s.corruptRate > 0 && std::bernoulli_distribution(s.corruptRate)(s.rng);
+    frameData->amplitudes = s.amplitudes.data();
+    return MAXLAB_OK;
+}
+
+} // namespace maxlab
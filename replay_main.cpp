@@ -0,0 +1,116 @@
+#include "Replay.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// 用法: Dino_replay <DINO_RECORD_DIR> [--policy FILE] [--window F] [--bin F] [--threshold T] [--channels LIST]
+// 不带解码参数时按记录的输入逐位回放并核对每局的校验和；
+// 带任一解码参数时用新参数重新解码记录的 spike，与原会话逐局比较
+static void Usage(const char* name) {
+    fprintf(stderr, "Call with: %s <record_dir> [--policy FILE] [--window F] [--bin F] [--threshold T] [--channels LIST]\n", name);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc % 2 != 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+    const char* policy_path = "stim_policy.cfg";
+    DecoderConfig decoder_config;
+    bool redecode = false;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        const char* value = argv[i + 1];
+        if (strcmp(argv[i], "--policy") == 0) {
+            policy_path = value;
+        } else if (strcmp(argv[i], "--window") == 0) {
+            decoder_config.window_frames = strtoul(value, nullptr, 10);
+            redecode = true;
+        } else if (strcmp(argv[i], "--bin") == 0) {
+            decoder_config.bin_frames = strtoul(value, nullptr, 10);
+            redecode = true;
+        } else if (strcmp(argv[i], "--threshold") == 0) {
+            decoder_config.threshold = strtoul(value, nullptr, 10);
+            redecode = true;
+        } else if (strcmp(argv[i], "--channels") == 0) {
+            decoder_config.channels = value;
+            redecode = true;
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    SessionReader reader;
+    if (!reader.Open(argv[1])) {
+        return 1;
+    }
+    RecordedSession session;
+    if (!LoadRecordedSession(reader, session)) {
+        if (session.geometry_mismatch) {
+            fprintf(stderr, "%s: recorded geometry does not match this build (%d fields expected)\n", argv[1], kGeometryFields);
+            return 1;
+        }
+        fprintf(stderr, "%s has no replay records (geometry/seed/input events)\n", argv[1]);
+        return 1;
+    }
+
+    // 多井会话每个井一个重新解码器，只取该井的 spike
+    StimPolicyStore policies;
+    std::unique_ptr<Redecoder> redecoders[256];
+    if (redecode) {
+        policies.Reload(policy_path);
+        for (const RecordedGame& game : session.games) {
+            std::unique_ptr<Redecoder>& redecoder = redecoders[game.well];
+            if (redecoder != nullptr) {
+                continue;
+            }
+            redecoder = std::make_unique<Redecoder>(reader, *policies.Current(), session.multiwell ? game.well : -1);
+            if (!redecoder->Configure(decoder_config)) {
+                return 1;
+            }
+        }
+    }
+
+    uint64_t total_ticks = 0;
+    int mismatches = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t g = 0; g < session.games.size(); ++g) {
+        const RecordedGame& game = session.games[g];
+        const ReplayResult recorded = ReplayGame(game, session.geometry);
+        total_ticks += recorded.ticks;
+
+        if (!redecode) {
+            const bool match = !game.ended || recorded.checksum == game.checksum;
+            if (!match) {
+                ++mismatches;
+            }
+            if (session.multiwell) {
+                printf("well %u ", game.well);
+            }
+            printf("game %zu seed=%lu ticks=%lu score=%lu collisions=%lu jumps key=%lu decoded=%lu %s%s\n",
+                   g, game.seed, recorded.ticks, recorded.score, recorded.collisions, recorded.key_jumps,
+                   recorded.decoded_jumps, !game.ended ? "unterminated" : match ? "checksum ok" : "CHECKSUM MISMATCH",
+                   game.missing > 0 ? " (input records missing)" : "");
+            continue;
+        }
+
+        const ReplayResult replayed = redecoders[game.well]->Run(game, session.geometry);
+        total_ticks += replayed.ticks;
+        if (session.multiwell) {
+            printf("well %u ", game.well);
+        }
+        printf("game %zu ticks %lu -> %lu score %lu -> %lu collisions %lu -> %lu decoded jumps %lu -> %lu%s\n",
+               g, recorded.ticks, replayed.ticks, recorded.score, replayed.score, recorded.collisions, replayed.collisions,
+               recorded.decoded_jumps, replayed.decoded_jumps, replayed.died && !recorded.died ? " (died earlier)" : "");
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%zu games, %lu ticks replayed in %.3f s (%.0fx real time)\n", session.games.size(), total_ticks, seconds,
+           seconds > 0 ? total_ticks / (mFPS * seconds) : 0.0);
+    if (mismatches > 0) {
+        printf("%d games did not replay bit-exactly\n", mismatches);
+        return 2;
+    }
+    return 0;
+}
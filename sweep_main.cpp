@@ -0,0 +1,183 @@
+#include "Sweep.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// 用法: Dino_sweep [--threads N] [--ticks N] [--seeds N] [--policy FILE] [--out FILE] [--bin F]
+//                  [--threshold A] [--window A] [--isi-scale A] [--min-interval A] [--evoked A]
+// A 为 "a,b,c" 或 "起:止:步长"，各轴做笛卡尔积；每组参数跑 seeds 个种子，结果按参数汇总成一行
+// threshold、min-interval 为非负整数，window 为正整数，isi-scale 为正数，evoked 为非负数
+static void Usage(const char* name) {
+    fprintf(stderr, "Call with: %s [--threads N] [--ticks N] [--seeds N] [--policy FILE] [--out FILE] [--bin F]\n"
+                    "           [--threshold A] [--window A] [--isi-scale A] [--min-interval A] [--evoked A]\n"
+                    "A is a,b,c or lo:hi:step\n", name);
+}
+
+// 一个轴的取值范围：下限 0 时 zero_ok 决定是否含 0，integral 的轴不接受小数
+static bool AxisValid(const char* name, const std::vector<double>& axis, bool zero_ok, bool integral, double max) {
+    for (double value : axis) {
+        if (!std::isfinite(value) || !(zero_ok ? value >= 0 : value > 0) || value > max ||
+            (integral && value != std::floor(value))) {
+            fprintf(stderr, "Invalid %s %g: expected %s in %s0, %.0f%s\n", name, value,
+                    integral ? "an integer" : "a number", zero_ok ? "[" : "(", max, std::isfinite(max) ? "]" : ")");
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned threads = 0;
+    unsigned seeds = 4;
+    const char* policy_path = "stim_policy.cfg";
+    const char* out_path = "sweep.csv";
+    SweepOptions options;
+    std::vector<double> thresholds{10}, windows{1000}, isi_scales{1.0}, intervals{MinInterval_Half}, evoked{12};
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* value = argv[i + 1];
+        bool ok = true;
+        if (strcmp(argv[i], "--threads") == 0) {
+            threads = strtoul(value, nullptr, 10);
+        } else if (strcmp(argv[i], "--ticks") == 0) {
+            options.ticks = strtoull(value, nullptr, 10);
+        } else if (strcmp(argv[i], "--seeds") == 0) {
+            seeds = strtoul(value, nullptr, 10);
+        } else if (strcmp(argv[i], "--policy") == 0) {
+            policy_path = value;
+        } else if (strcmp(argv[i], "--out") == 0) {
+            out_path = value;
+        } else if (strcmp(argv[i], "--bin") == 0) {
+            options.bin_frames = strtoul(value, nullptr, 10);
+        } else if (strcmp(argv[i], "--threshold") == 0) {
+            ok = ParseSweepAxis(value, thresholds);
+        } else if (strcmp(argv[i], "--window") == 0) {
+            ok = ParseSweepAxis(value, windows);
+        } else if (strcmp(argv[i], "--isi-scale") == 0) {
+            ok = ParseSweepAxis(value, isi_scales);
+        } else if (strcmp(argv[i], "--min-interval") == 0) {
+            ok = ParseSweepAxis(value, intervals);
+        } else if (strcmp(argv[i], "--evoked") == 0) {
+            ok = ParseSweepAxis(value, evoked);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "Invalid argument %s %s\n", argv[i], value);
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if (argc % 2 == 0 || seeds == 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    // 展开参数网格前先检查每个轴的取值，避免跑了一夜才发现某一行无效
+    const int max_interval = MaxMinIntervalHalf(DefaultGeometry());
+    const double unbounded = HUGE_VAL;
+    if (!AxisValid("threshold", thresholds, true, true, UINT32_MAX) ||
+        !AxisValid("window", windows, false, true, UINT32_MAX) ||
+        !AxisValid("isi-scale", isi_scales, false, false, unbounded) ||
+        !AxisValid("min-interval", intervals, true, true, max_interval) ||
+        !AxisValid("evoked", evoked, true, false, unbounded)) {
+        return 1;
+    }
+
+    StimPolicyStore policies;
+    policies.Reload(policy_path);
+    options.policy = policies.Current();
+
+    // 展开参数网格
+    std::vector<SweepParams> grid;
+    for (double threshold : thresholds)
+    for (double window : windows)
+    for (double isi_scale : isi_scales)
+    for (double interval : intervals)
+    for (double spikes : evoked) {
+        SweepParams params;
+        params.threshold = static_cast<uint32_t>(threshold);
+        params.window_frames = static_cast<uint32_t>(window);
+        params.isi_scale = isi_scale;
+        params.min_interval_half = static_cast<int>(interval);
+        params.evoked_spikes = static_cast<float>(spikes);
+        grid.push_back(params);
+    }
+    {
+        SpikeDecoder check;
+        for (const SweepParams& params : grid) {
+            DecoderConfig config;
+            config.window_frames = params.window_frames;
+            config.bin_frames = options.bin_frames;
+            if (!check.Configure(config)) {
+                return 1;
+            }
+        }
+    }
+
+    // 任务编号 = 参数行 × seeds + 种子，结果按编号写回，输出顺序与调度无关
+    const size_t jobs = grid.size() * seeds;
+    std::vector<SweepRun> runs(jobs);
+    WorkStealingPool pool(threads);
+    std::vector<std::unique_ptr<SweepWorker>> workers;
+    for (unsigned w = 0; w < pool.Threads(); ++w) {
+        workers.push_back(std::make_unique<SweepWorker>());
+    }
+    printf("%zu configurations x %u seeds = %zu runs of %lu ticks on %u threads\n",
+           grid.size(), seeds, jobs, options.ticks, pool.Threads());
+
+    std::atomic<size_t> done{0};
+    const auto start = std::chrono::steady_clock::now();
+    pool.Run(jobs, [&](size_t job, unsigned worker) {
+        runs[job] = workers[worker]->Run(grid[job / seeds], options, job % seeds + 1);
+        const size_t finished = done.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (finished % 256 == 0 || finished == jobs) {
+            fprintf(stderr, "\r%zu / %zu", finished, jobs);
+        }
+    });
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "\n");
+
+    FILE* out = fopen(out_path, "w");
+    if (out == nullptr) {
+        fprintf(stderr, "Cannot open %s\n", out_path);
+        return 1;
+    }
+    fprintf(out, "threshold,window_frames,isi_scale,min_interval_half,evoked_spikes,seeds,ticks,"
+                 "games,mean_score,best_score,collisions_per_game,stims_per_kilotick,jumps_per_kilotick\n");
+    for (size_t row = 0; row < grid.size(); ++row) {
+        SweepRun total;
+        for (unsigned s = 0; s < seeds; ++s) {
+            const SweepRun& run = runs[row * seeds + s];
+            total.games += run.games;
+            total.collisions += run.collisions;
+            total.stims += run.stims;
+            total.decoded_jumps += run.decoded_jumps;
+            total.score_sum += run.score_sum;
+            total.last_score += run.last_score;
+            if (run.best_score > total.best_score) {
+                total.best_score = run.best_score;
+            }
+        }
+        // 没有一局结束时（表现很好）用未结束局的得分
+        const double mean_score = total.games > 0 ? static_cast<double>(total.score_sum) / total.games
+                                                  : static_cast<double>(total.last_score) / seeds;
+        const double kiloticks = options.ticks * seeds / 1000.0;
+        const SweepParams& p = grid[row];
+        fprintf(out, "%u,%u,%g,%d,%g,%u,%lu,%lu,%.1f,%lu,%.2f,%.2f,%.2f\n",
+                p.threshold, p.window_frames, p.isi_scale, p.min_interval_half, p.evoked_spikes, seeds, options.ticks,
+                total.games, mean_score, total.best_score,
+                total.games > 0 ? static_cast<double>(total.collisions) / total.games : static_cast<double>(total.collisions),
+                total.stims / kiloticks, total.decoded_jumps / kiloticks);
+    }
+    fclose(out);
+
+    printf("%.1f s, %.0f ticks/s, %lu jobs stolen, results in %s\n", seconds,
+           seconds > 0 ? jobs * options.ticks / seconds : 0.0, pool.Stolen(), out_path);
+    return 0;
+}